@@ -3,6 +3,7 @@
 #include "system_comms.h"
 #include "system_debug.h"
 #include "protocol_data.h"
+#include "tx_telemetry.h"
 
 void full_error_diagnostic(void) {
     if (debug_flags.diagnostic_printed) return;
@@ -17,12 +18,11 @@ void full_error_diagnostic(void) {
         while(1); // Blocage systme
     }
     
-    // 2. Test GPS - SUPPRIMER la variable 'pos' inutilise
-    set_gps_position(TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE);
-    encode_gps_position_complete(current_latitude, current_longitude);
+    // 2. Sante RF : verrouillage PLL, depassements Timer1, age du fix GPS
+    telemetry_health_report();
     
     // 3. Vrification mmoire
-    if(sizeof(beacon_frame) != MESSAGE_BITS) {
+    if(sizeof(beacon_frame) != MESSAGE_BYTES) {
         debug_print_str("ERREUR: Taille frame incorrecte!\r\n");
     }
     
@@ -60,3 +60,329 @@ void verify_cs_t001_constants(void) {
     debug_print_str((COUNTRY_CODE_FRANCE == 227) ? " ✓" : " ✗ SHOULD BE 227");
     debug_print_str("\r\n");
 }
+
+// =============================
+// Decodeur BCH (syndromes + Peterson + Chien)
+// =============================
+// BCH(82,61) t=3 : code raccourci de (127,106), g = m1.m3.m5 sur GF(2^7),
+// polynome primitif x^7 + x^3 + 1. BCH(38,26) t=2 : raccourci de (63,51),
+// g = m1.m3 sur GF(2^6), x^6 + x + 1. Le reste r(x) = c(x) mod g(x) vient
+// de l'encodeur (compute_bch1/2, memes tables) et S_j = r(alpha^j).
+// Position p dans le mot de code = degre du terme : bit de trame
+// BCHx_CODEWORD_END - p.
+
+// alpha^i, i < 2n : somme de deux logs sans modulo
+static const uint8_t gf128_exp[254] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x09, 0x12, 0x24, 0x48, 0x19, 0x32, 0x64, 0x41, 0x0B,
+    0x16, 0x2C, 0x58, 0x39, 0x72, 0x6D, 0x53, 0x2F, 0x5E, 0x35, 0x6A, 0x5D, 0x33, 0x66, 0x45, 0x03,
+    0x06, 0x0C, 0x18, 0x30, 0x60, 0x49, 0x1B, 0x36, 0x6C, 0x51, 0x2B, 0x56, 0x25, 0x4A, 0x1D, 0x3A,
+    0x74, 0x61, 0x4B, 0x1F, 0x3E, 0x7C, 0x71, 0x6B, 0x5F, 0x37, 0x6E, 0x55, 0x23, 0x46, 0x05, 0x0A,
+    0x14, 0x28, 0x50, 0x29, 0x52, 0x2D, 0x5A, 0x3D, 0x7A, 0x7D, 0x73, 0x6F, 0x57, 0x27, 0x4E, 0x15,
+    0x2A, 0x54, 0x21, 0x42, 0x0D, 0x1A, 0x34, 0x68, 0x59, 0x3B, 0x76, 0x65, 0x43, 0x0F, 0x1E, 0x3C,
+    0x78, 0x79, 0x7B, 0x7F, 0x77, 0x67, 0x47, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0x69, 0x5B, 0x3F, 0x7E,
+    0x75, 0x63, 0x4F, 0x17, 0x2E, 0x5C, 0x31, 0x62, 0x4D, 0x13, 0x26, 0x4C, 0x11, 0x22, 0x44, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x09, 0x12, 0x24, 0x48, 0x19, 0x32, 0x64, 0x41, 0x0B, 0x16,
+    0x2C, 0x58, 0x39, 0x72, 0x6D, 0x53, 0x2F, 0x5E, 0x35, 0x6A, 0x5D, 0x33, 0x66, 0x45, 0x03, 0x06,
+    0x0C, 0x18, 0x30, 0x60, 0x49, 0x1B, 0x36, 0x6C, 0x51, 0x2B, 0x56, 0x25, 0x4A, 0x1D, 0x3A, 0x74,
+    0x61, 0x4B, 0x1F, 0x3E, 0x7C, 0x71, 0x6B, 0x5F, 0x37, 0x6E, 0x55, 0x23, 0x46, 0x05, 0x0A, 0x14,
+    0x28, 0x50, 0x29, 0x52, 0x2D, 0x5A, 0x3D, 0x7A, 0x7D, 0x73, 0x6F, 0x57, 0x27, 0x4E, 0x15, 0x2A,
+    0x54, 0x21, 0x42, 0x0D, 0x1A, 0x34, 0x68, 0x59, 0x3B, 0x76, 0x65, 0x43, 0x0F, 0x1E, 0x3C, 0x78,
+    0x79, 0x7B, 0x7F, 0x77, 0x67, 0x47, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0x69, 0x5B, 0x3F, 0x7E, 0x75,
+    0x63, 0x4F, 0x17, 0x2E, 0x5C, 0x31, 0x62, 0x4D, 0x13, 0x26, 0x4C, 0x11, 0x22, 0x44
+};
+
+static const uint8_t gf128_log[128] = {
+    0x00, 0x00, 0x01, 0x1F, 0x02, 0x3E, 0x20, 0x67, 0x03, 0x07, 0x3F, 0x0F, 0x21, 0x54, 0x68, 0x5D,
+    0x04, 0x7C, 0x08, 0x79, 0x40, 0x4F, 0x10, 0x73, 0x22, 0x0B, 0x55, 0x26, 0x69, 0x2E, 0x5E, 0x33,
+    0x05, 0x52, 0x7D, 0x3C, 0x09, 0x2C, 0x7A, 0x4D, 0x41, 0x43, 0x50, 0x2A, 0x11, 0x45, 0x74, 0x17,
+    0x23, 0x76, 0x0C, 0x1C, 0x56, 0x19, 0x27, 0x39, 0x6A, 0x13, 0x2F, 0x59, 0x5F, 0x47, 0x34, 0x6E,
+    0x06, 0x0E, 0x53, 0x5C, 0x7E, 0x1E, 0x3D, 0x66, 0x0A, 0x25, 0x2D, 0x32, 0x7B, 0x78, 0x4E, 0x72,
+    0x42, 0x29, 0x44, 0x16, 0x51, 0x3B, 0x2B, 0x4C, 0x12, 0x58, 0x46, 0x6D, 0x75, 0x1B, 0x18, 0x38,
+    0x24, 0x31, 0x77, 0x71, 0x0D, 0x5B, 0x1D, 0x65, 0x57, 0x6C, 0x1A, 0x37, 0x28, 0x15, 0x3A, 0x4B,
+    0x6B, 0x36, 0x14, 0x4A, 0x30, 0x70, 0x5A, 0x64, 0x60, 0x61, 0x48, 0x62, 0x35, 0x49, 0x6F, 0x63
+};
+
+static const uint8_t gf64_exp[126] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x23, 0x05, 0x0A, 0x14, 0x28,
+    0x13, 0x26, 0x0F, 0x1E, 0x3C, 0x3B, 0x35, 0x29, 0x11, 0x22, 0x07, 0x0E, 0x1C, 0x38, 0x33, 0x25,
+    0x09, 0x12, 0x24, 0x0B, 0x16, 0x2C, 0x1B, 0x36, 0x2F, 0x1D, 0x3A, 0x37, 0x2D, 0x19, 0x32, 0x27,
+    0x0D, 0x1A, 0x34, 0x2B, 0x15, 0x2A, 0x17, 0x2E, 0x1F, 0x3E, 0x3F, 0x3D, 0x39, 0x31, 0x21, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x23, 0x05, 0x0A, 0x14, 0x28, 0x13,
+    0x26, 0x0F, 0x1E, 0x3C, 0x3B, 0x35, 0x29, 0x11, 0x22, 0x07, 0x0E, 0x1C, 0x38, 0x33, 0x25, 0x09,
+    0x12, 0x24, 0x0B, 0x16, 0x2C, 0x1B, 0x36, 0x2F, 0x1D, 0x3A, 0x37, 0x2D, 0x19, 0x32, 0x27, 0x0D,
+    0x1A, 0x34, 0x2B, 0x15, 0x2A, 0x17, 0x2E, 0x1F, 0x3E, 0x3F, 0x3D, 0x39, 0x31, 0x21
+};
+
+static const uint8_t gf64_log[64] = {
+    0x00, 0x00, 0x01, 0x06, 0x02, 0x0C, 0x07, 0x1A, 0x03, 0x20, 0x0D, 0x23, 0x08, 0x30, 0x1B, 0x12,
+    0x04, 0x18, 0x21, 0x10, 0x0E, 0x34, 0x24, 0x36, 0x09, 0x2D, 0x31, 0x26, 0x1C, 0x29, 0x13, 0x38,
+    0x05, 0x3E, 0x19, 0x0B, 0x22, 0x1F, 0x11, 0x2F, 0x0F, 0x17, 0x35, 0x33, 0x25, 0x2C, 0x37, 0x28,
+    0x0A, 0x3D, 0x2E, 0x1E, 0x32, 0x16, 0x27, 0x2B, 0x1D, 0x3C, 0x2A, 0x15, 0x14, 0x3B, 0x39, 0x3A
+};
+
+typedef struct {
+    const uint8_t *exp;
+    const uint8_t *log;
+    uint8_t n;                  // 2^m - 1
+} gf_field_t;
+
+static const gf_field_t gf128 = { gf128_exp, gf128_log, 127 };
+static const gf_field_t gf64 = { gf64_exp, gf64_log, 63 };
+
+static uint8_t gf_mul(const gf_field_t *f, uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return f->exp[f->log[a] + f->log[b]];
+}
+
+static uint8_t gf_div(const gf_field_t *f, uint8_t a, uint8_t b) {
+    if (a == 0) return 0;
+    return f->exp[f->log[a] + f->n - f->log[b]];
+}
+
+// S_j = r(alpha^j), r sur nbits bits
+static uint8_t gf_syndrome(const gf_field_t *f, uint32_t r, uint8_t nbits, uint8_t j) {
+    uint8_t s = 0;
+    uint8_t e = 0;              // k.j mod n
+    
+    for (uint8_t k = 0; k < nbits; k++) {
+        if ((r >> k) & 1) s ^= f->exp[e];
+        e += j;
+        if (e >= f->n) e -= f->n;
+    }
+    return s;
+}
+
+// Racines alpha^-p de sigma(x) = 1 + s1.x + s2.x^2 + s3.x^3 pour p < len.
+// Recherche incrementale : le log de chaque terme perd k a chaque position.
+static uint8_t gf_chien(const gf_field_t *f, const uint8_t *sigma, uint8_t deg,
+                        uint8_t len, uint8_t *pos) {
+    uint8_t l[BCH1_T + 1];
+    uint8_t found = 0;
+    
+    for (uint8_t k = 1; k <= deg; k++) l[k] = f->log[sigma[k]];
+    
+    for (uint8_t p = 0; p < len && found < deg; p++) {
+        uint8_t v = 1;
+        for (uint8_t k = 1; k <= deg; k++) {
+            if (sigma[k] == 0) continue;
+            v ^= f->exp[l[k]];
+            l[k] = (l[k] >= k) ? (uint8_t)(l[k] - k) : (uint8_t)(l[k] + f->n - k);
+        }
+        if (v == 0) pos[found++] = p;
+    }
+    return found;
+}
+
+void frame_flip_bit(packed_frame_t *frame, uint16_t cs_bit) {
+    uint16_t idx = CS_BIT(cs_bit);
+    frame->w[idx >> 4] ^= (uint16_t)(0x8000u >> (idx & 0x0F));
+}
+
+static uint32_t bch1_remainder(const packed_frame_t *frame) {
+    return compute_bch1(get_bit_field(frame, 25, BCH1_DATA_BITS)) ^
+           (uint32_t)get_bit_field(frame, FRAME_BCH1_START, FRAME_BCH1_LENGTH);
+}
+
+static uint16_t bch2_remainder(const packed_frame_t *frame) {
+    return compute_bch2((uint32_t)get_bit_field(frame, 107, BCH2_DATA_BITS)) ^
+           (uint16_t)get_bit_field(frame, FRAME_BCH2_START, FRAME_BCH2_LENGTH);
+}
+
+// Corrige jusqu'a 3 bits dans le mot BCH1 (bits 25-106).
+// Retour : bits corriges, -1 = non corrigeable (trame inchangee).
+int8_t bch1_correct(packed_frame_t *frame) {
+    uint32_t r = bch1_remainder(frame);
+    uint8_t sigma[BCH1_T + 1] = { 1, 0, 0, 0 };
+    uint8_t pos[BCH1_T];
+    uint8_t deg;
+    
+    if (r == 0) return 0;
+    
+    uint8_t s1 = gf_syndrome(&gf128, r, BCH1_DEGREE, 1);
+    uint8_t s3 = gf_syndrome(&gf128, r, BCH1_DEGREE, 3);
+    uint8_t s5 = gf_syndrome(&gf128, r, BCH1_DEGREE, 5);
+    uint8_t s1_2 = gf_mul(&gf128, s1, s1);
+    uint8_t s1_3 = gf_mul(&gf128, s1_2, s1);
+    uint8_t den = s1_3 ^ s3;
+    
+    sigma[1] = s1;
+    if (den == 0) {
+        // Une seule erreur : S3 = S1^3 et S5 = S1^5
+        if (s1 == 0 || s5 != gf_mul(&gf128, s1_3, s1_2)) return -1;
+        deg = 1;
+    } else {
+        sigma[2] = gf_div(&gf128, gf_mul(&gf128, s1_2, s3) ^ s5, den);
+        sigma[3] = den ^ gf_mul(&gf128, s1, sigma[2]);
+        deg = sigma[3] ? 3 : (sigma[2] ? 2 : 1);
+    }
+    
+    if (gf_chien(&gf128, sigma, deg, BCH1_CODEWORD_BITS, pos) != deg) return -1;
+    for (uint8_t i = 0; i < deg; i++) frame_flip_bit(frame, BCH1_CODEWORD_END - pos[i]);
+    
+    // Plus de t erreurs peut donner un localisateur coherent mais faux
+    if (bch1_remainder(frame) != 0) {
+        for (uint8_t i = 0; i < deg; i++) frame_flip_bit(frame, BCH1_CODEWORD_END - pos[i]);
+        return -1;
+    }
+    return (int8_t)deg;
+}
+
+// Corrige jusqu'a 2 bits dans le mot BCH2 (bits 107-144).
+int8_t bch2_correct(packed_frame_t *frame) {
+    uint16_t r = bch2_remainder(frame);
+    uint8_t sigma[BCH2_T + 1] = { 1, 0, 0 };
+    uint8_t pos[BCH2_T];
+    uint8_t deg;
+    
+    if (r == 0) return 0;
+    
+    uint8_t s1 = gf_syndrome(&gf64, r, BCH2_DEGREE, 1);
+    uint8_t s3 = gf_syndrome(&gf64, r, BCH2_DEGREE, 3);
+    uint8_t s1_3 = gf_mul(&gf64, gf_mul(&gf64, s1, s1), s1);
+    
+    if (s1 == 0) return -1;
+    sigma[1] = s1;
+    if (s3 == s1_3) {
+        deg = 1;
+    } else {
+        sigma[2] = gf_div(&gf64, s3 ^ s1_3, s1);
+        deg = 2;
+    }
+    
+    if (gf_chien(&gf64, sigma, deg, BCH2_CODEWORD_BITS, pos) != deg) return -1;
+    for (uint8_t i = 0; i < deg; i++) frame_flip_bit(frame, BCH2_CODEWORD_END - pos[i]);
+    
+    if (bch2_remainder(frame) != 0) {
+        for (uint8_t i = 0; i < deg; i++) frame_flip_bit(frame, BCH2_CODEWORD_END - pos[i]);
+        return -1;
+    }
+    return (int8_t)deg;
+}
+
+// =============================
+// Injection d'erreurs (test recepteurs)
+// =============================
+static uint8_t bch_inject_n1 = 0;          // Bits inverses par burst dans BCH1
+static uint8_t bch_inject_n2 = 0;          // ... dans BCH2
+static uint32_t bch_rand_state = 0x6C078965UL;
+
+static uint32_t bch_rand(void) {
+    uint32_t x = bch_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bch_rand_state = x;
+    return x;
+}
+
+void bch_set_error_injection(uint8_t n1, uint8_t n2) {
+    bch_inject_n1 = (n1 > BCH1_CODEWORD_BITS) ? BCH1_CODEWORD_BITS : n1;
+    bch_inject_n2 = (n2 > BCH2_CODEWORD_BITS) ? BCH2_CODEWORD_BITS : n2;
+}
+
+// n positions distinctes tirees dans un mot de code
+static void bch_flip_random(packed_frame_t *frame, uint8_t end, uint8_t len, uint8_t n) {
+    uint8_t used[(BCH1_CODEWORD_BITS + 7) / 8] = { 0 };
+    
+    while (n) {
+        uint8_t p = (uint8_t)(bch_rand() % len);
+        if (used[p >> 3] & (1u << (p & 7))) continue;
+        used[p >> 3] |= (uint8_t)(1u << (p & 7));
+        frame_flip_bit(frame, end - p);
+        n--;
+    }
+}
+
+// Appele sur le tampon arriere juste avant chaque burst
+void bch_inject_errors(packed_frame_t *frame) {
+    if (bch_inject_n1) bch_flip_random(frame, BCH1_CODEWORD_END, BCH1_CODEWORD_BITS, bch_inject_n1);
+    if (bch_inject_n2) bch_flip_random(frame, BCH2_CODEWORD_END, BCH2_CODEWORD_BITS, bch_inject_n2);
+}
+
+// =============================
+// Auto-test exhaustif (commande BCH TEST)
+// =============================
+typedef struct {
+    uint32_t corrected;         // Trame d'origine restituee
+    uint32_t detected;          // Rejetee (-1)
+    uint32_t miscorrected;      // Corrigee vers une autre trame
+} bch_sweep_t;
+
+// Tous les motifs de 'weight' erreurs dans un mot de code
+static void bch_sweep(const packed_frame_t *ref, int8_t (*correct)(packed_frame_t *),
+                      uint8_t end, uint8_t len, uint8_t weight, bch_sweep_t *res) {
+    uint8_t idx[BCH_SELFTEST_MAX_WEIGHT];
+    packed_frame_t f;
+    
+    for (uint8_t i = 0; i < weight; i++) idx[i] = i;
+    memset(res, 0, sizeof(*res));
+    
+    while (1) {
+        f = *ref;
+        for (uint8_t i = 0; i < weight; i++) frame_flip_bit(&f, end - idx[i]);
+        
+        int8_t n = correct(&f);
+        if (n < 0) {
+            res->detected++;
+        } else if (n == (int8_t)weight && memcmp(&f, ref, sizeof(f)) == 0) {
+            res->corrected++;
+        } else {
+            res->miscorrected++;
+        }
+        
+        // Combinaison suivante
+        int8_t i = (int8_t)weight - 1;
+        while (i >= 0 && idx[i] == len - weight + i) i--;
+        if (i < 0) break;
+        idx[i]++;
+        for (uint8_t j = (uint8_t)i + 1; j < weight; j++) idx[j] = idx[j - 1] + 1;
+    }
+}
+
+static void bch_sweep_report(const char *name, uint8_t weight, const bch_sweep_t *res) {
+    DEBUG_LOG_FLUSH(name);
+    DEBUG_LOG_FLUSH(" w");
+    debug_print_uint16(weight);
+    DEBUG_LOG_FLUSH(": ok ");
+    debug_print_uint32(res->corrected);
+    DEBUG_LOG_FLUSH(" rejected ");
+    debug_print_uint32(res->detected);
+    DEBUG_LOG_FLUSH(" wrong ");
+    debug_print_uint32(res->miscorrected);
+    DEBUG_LOG_FLUSH("\r\n");
+}
+
+// 1-3 erreurs BCH1 et 1-2 erreurs BCH2 doivent toutes etre corrigees ;
+// t+1 erreurs BCH2 : rejet ou mauvaise correction, statistique seulement.
+// Bloque le contexte main pendant quelques secondes.
+uint8_t bch_selftest(void) {
+    frame_cache_t cache;
+    bch_sweep_t res;
+    uint32_t failures = 0;
+    uint32_t patterns = 0;
+    uint32_t t0 = timebase_millis();
+    
+    frame_cache_init(&cache, BEACON_DEFAULT_ID, COUNTRY_CODE_FRANCE);
+    frame_cache_update(&cache, BEACON_MODE_EXERCISE, TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE);
+    DEBUG_LOG_FLUSH("=== BCH SELF-TEST ===\r\n");
+    
+    for (uint8_t w = 1; w <= BCH1_T; w++) {
+        bch_sweep(&cache.frame, bch1_correct, BCH1_CODEWORD_END, BCH1_CODEWORD_BITS, w, &res);
+        bch_sweep_report("BCH1", w, &res);
+        failures += res.detected + res.miscorrected;
+        patterns += res.corrected + res.detected + res.miscorrected;
+    }
+    for (uint8_t w = 1; w <= BCH2_T + 1; w++) {
+        bch_sweep(&cache.frame, bch2_correct, BCH2_CODEWORD_END, BCH2_CODEWORD_BITS, w, &res);
+        bch_sweep_report("BCH2", w, &res);
+        if (w <= BCH2_T) failures += res.detected + res.miscorrected;
+        patterns += res.corrected + res.detected + res.miscorrected;
+    }
+    
+    DEBUG_LOG_FLUSH("Patterns: ");
+    debug_print_uint32(patterns);
+    DEBUG_LOG_FLUSH(" in ");
+    debug_print_uint32(timebase_millis() - t0);
+    DEBUG_LOG_FLUSH(failures ? " ms - FAIL\r\n" : " ms - PASS\r\n");
+    return failures == 0;
+}
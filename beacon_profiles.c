@@ -0,0 +1,243 @@
+/* beacon_profiles.c - Multi-beacon profiles and EDF burst scheduling
+ * Each profile owns a frame cache that is kept encoded and BCH-checked
+ * between bursts; the earliest-deadline profile is copied into the back
+ * buffer ahead of time, so starting a burst is only a slot swap. Periods
+ * are randomised per burst (T.001: base +/-5%) and bursts never overlap.
+ * T.018 profiles keep their own cache: the OQPSK engine copies the frame
+ * at start, the back buffer is not used.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_comms.h"
+#include "system_debug.h"
+#include "system_scheduler.h"
+#include "protocol_data.h"
+#include "rf_interface.h"
+#include "beacon_profiles.h"
+#include "sgb_frame.h"
+#include "tx_oqpsk.h"
+#include "tx_telemetry.h"
+
+// =============================
+// Profile table
+// =============================
+// Entry 0 is the primary beacon: TEST/EXERCISE follows the RB12 switch as
+// in single-beacon builds, T.001/T.018 the FORMAT command. Others are fixed training beacons around the
+// test position (10000 units = 1 minute of arc); the last one is a
+// second-generation (T.018) beacon.
+static const beacon_profile_t beacon_profile_table[BEACON_PROFILES_MAX] = {
+    { BEACON_DEFAULT_ID,   COUNTRY_CODE_FRANCE, BEACON_MODE_SWITCH,   RF_POWER_LOW, 0,
+      TEST_LATITUDE,          TEST_LONGITUDE,          TEST_ALTITUDE,  5000, BEACON_FORMAT_FGB },
+    { BEACON_DEFAULT_ID + 1, COUNTRY_CODE_FRANCE, BEACON_MODE_EXERCISE, RF_POWER_LOW, 0,
+      TEST_LATITUDE + 20000L, TEST_LONGITUDE - 30000L, 12500L,         50000, BEACON_FORMAT_FGB },
+    { BEACON_DEFAULT_ID + 2, COUNTRY_CODE_FRANCE, BEACON_MODE_EXERCISE, RF_POWER_LOW, 0,
+      TEST_LATITUDE - 15000L, TEST_LONGITUDE + 25000L, 9000L,          50000, BEACON_FORMAT_FGB },
+    { BEACON_DEFAULT_ID + 3, COUNTRY_CODE_FRANCE, BEACON_MODE_EXERCISE, RF_POWER_LOW, 0,
+      TEST_LATITUDE + 5000L,  TEST_LONGITUDE + 40000L, 15000L,         50000, BEACON_FORMAT_SGB },
+};
+
+// Runtime state per active profile
+typedef struct {
+    frame_cache_t cache;        // Encoded frame, updated only on change
+    sgb_cache_t sgb;            // Same for T.018 profiles
+    uint32_t next_due;          // Absolute deadline (ms)
+    uint8_t frame_ok;           // BCH check of the cached frame
+} beacon_slot_t;
+
+static beacon_slot_t beacon_slots[BEACON_PROFILES_ACTIVE];
+static beacon_profile_t beacon_prepared_profile;    // Resolved profile in the back buffer
+static int8_t beacon_prepared = -1;                 // Profile in the back buffer (-1 = none)
+static uint8_t beacon_prepared_slot = 0;            // tx_ready_slot when it was copied
+static int8_t beacon_last = -1;
+static uint32_t beacon_slot_free = 0;               // Earliest start of the next burst
+static uint32_t beacon_rand_state = 0x2545F491UL;
+static uint8_t beacon_primary_format = BEACON_FORMAT_FGB;   // FORMAT command, profile 0
+
+// Lecture du switch de sélection mode
+beacon_frame_type_t get_frame_type_from_switch(void) {
+    // RB12 = 0 (pull-down) → TEST mode
+    // RB12 = 1 (switch pressed) → EXERCISE mode
+    return PORTBbits.RB12 ? BEACON_EXERCISE_FRAME : BEACON_TEST_FRAME;
+}
+
+// xorshift32: cheap, enough to decorrelate the repetition periods
+static uint32_t beacon_rand(void) {
+    uint32_t x = beacon_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    beacon_rand_state = x;
+    return x;
+}
+
+// Uniform in [base - 5%, base + 5%]
+static uint32_t beacon_jittered_period(uint32_t base_ms) {
+    uint32_t span = base_ms * BEACON_JITTER_PERMILLE / 1000;
+    return base_ms - span + beacon_rand() % (2 * span + 1);
+}
+
+// Concrete mode/position/power/period for this burst
+static void beacon_profile_resolve(uint8_t idx, beacon_profile_t *r) {
+    *r = beacon_profile_table[idx];
+    if (idx == 0) r->format = beacon_primary_format;
+
+    if (r->mode == BEACON_MODE_SWITCH) {
+        if (get_frame_type_from_switch() == BEACON_TEST_FRAME) {
+            r->mode = BEACON_MODE_TEST;     // Fixed coordinates, low power
+            r->use_gps = 0;
+            r->latitude = TEST_LATITUDE;
+            r->longitude = TEST_LONGITUDE;
+            r->altitude = TEST_ALTITUDE;
+            r->power = RF_POWER_LOW;
+            r->base_period_ms = 5000;
+        } else {
+            r->mode = BEACON_MODE_EXERCISE; // Current GPS fix, high power
+            r->use_gps = 1;
+            r->power = RF_POWER_HIGH;
+            r->base_period_ms = 50000;
+        }
+    }
+    if (r->use_gps) {
+        r->latitude = current_latitude;
+        r->longitude = current_longitude;
+        r->altitude = current_altitude;
+    }
+}
+
+// Earliest deadline first; ties keep table order
+static uint8_t beacon_sched_head(void) {
+    uint8_t head = 0;
+    for (uint8_t i = 1; i < BEACON_PROFILES_ACTIVE; i++) {
+        if ((int32_t)(beacon_slots[i].next_due - beacon_slots[head].next_due) < 0) {
+            head = i;
+        }
+    }
+    return head;
+}
+
+void beacon_sched_init(uint32_t now) {
+    beacon_rand_state ^= ((uint32_t)TMR1 << 16) ^ now;
+    if (beacon_rand_state == 0) beacon_rand_state = 0x2545F491UL;
+
+    for (uint8_t i = 0; i < BEACON_PROFILES_ACTIVE; i++) {
+        const beacon_profile_t *p = &beacon_profile_table[i];
+        frame_cache_init(&beacon_slots[i].cache, p->beacon_id, p->country);
+        sgb_cache_init(&beacon_slots[i].sgb, SGB_TAC_TRAINING, (uint16_t)p->beacon_id, p->country);
+        beacon_slots[i].frame_ok = 0;
+        beacon_slots[i].next_due = now + (uint32_t)i * BEACON_SLOT_MS;  // Staggered start
+        beacon_rand_state ^= p->beacon_id;
+    }
+    beacon_prepared = -1;
+    beacon_last = -1;
+    beacon_slot_free = now;
+}
+
+// Keep the back buffer loaded with the next profile's up-to-date frame.
+// The back slot is never the one on air once start_transmission() has
+// published, so this may run during a burst.
+void beacon_sched_prepare(void) {
+    uint8_t head = beacon_sched_head();
+    beacon_slot_t *s = &beacon_slots[head];
+    beacon_profile_t p;
+
+    beacon_profile_resolve(head, &p);
+    if (p.format == BEACON_FORMAT_SGB) {
+        if (sgb_cache_update(&s->sgb, p.mode, p.latitude, p.longitude, p.altitude)) {
+            s->frame_ok = SGB_OQPSK && sgb_frame_check_bch(&s->sgb.frame);
+            if (!s->frame_ok) DEBUG_LOG_FLUSH("Profile frame invalid, skipped\r\n");
+        }
+        beacon_prepared = s->frame_ok ? (int8_t)head : -1;
+        beacon_prepared_profile = p;
+        beacon_prepared_slot = tx_ready_slot;
+        return;
+    }
+    if (frame_cache_update(&s->cache, p.mode, p.latitude, p.longitude, p.altitude)) {
+        s->frame_ok = frame_check_bch(&s->cache.frame);
+        if (!s->frame_ok) DEBUG_LOG_FLUSH("Profile frame invalid, skipped\r\n");
+    } else if (beacon_prepared == (int8_t)head && beacon_prepared_slot == tx_ready_slot) {
+        return;     // Already in place
+    }
+
+    if (!s->frame_ok) {
+        beacon_prepared = -1;
+        return;
+    }
+    memcpy((void*)&beacon_frame, &s->cache.frame, sizeof(packed_frame_t));
+    beacon_prepared_profile = p;
+    beacon_prepared = (int8_t)head;
+    beacon_prepared_slot = tx_ready_slot;
+}
+
+uint32_t beacon_sched_next_due(void) {
+    uint32_t due = beacon_slots[beacon_sched_head()].next_due;
+    if ((int32_t)(beacon_slot_free - due) > 0) due = beacon_slot_free;  // No overlap
+    return due;
+}
+
+int8_t beacon_sched_last(void) {
+    return beacon_last;
+}
+
+// Both caches of the primary beacon are rebuilt: frame_ok is per slot
+uint8_t beacon_sched_set_format(uint8_t format) {
+#if !SGB_OQPSK
+    if (format == BEACON_FORMAT_SGB) return 0;
+#endif
+    if (format != BEACON_FORMAT_FGB && format != BEACON_FORMAT_SGB) return 0;
+    beacon_primary_format = format;
+    frame_cache_invalidate(&beacon_slots[0].cache);
+    beacon_slots[0].sgb.valid = 0;
+    beacon_slots[0].frame_ok = 0;
+    beacon_prepared = -1;
+    return 1;
+}
+
+uint8_t beacon_sched_format(void) {
+    return beacon_primary_format;
+}
+
+void beacon_sched_invalidate(void) {
+    beacon_prepared = -1;
+}
+
+uint8_t beacon_sched_start(void) {
+    if (tx_phase != IDLE_STATE) return 0;
+
+    uint8_t head = beacon_sched_head();
+    beacon_slot_t *s = &beacon_slots[head];
+    uint32_t now = sched_now();
+
+    if (beacon_prepared != (int8_t)head || beacon_prepared_slot != tx_ready_slot) {
+        beacon_sched_prepare();     // Late change (switch, first burst)
+    }
+    if (beacon_prepared != (int8_t)head) {
+        s->next_due = now + beacon_profile_table[head].base_period_ms;  // Retry later
+        return 0;
+    }
+
+    const beacon_profile_t *p = &beacon_prepared_profile;
+    beacon_mode = p->mode;
+    rf_set_power_level(p->power);       // RF chain is off between bursts
+    if (p->format == BEACON_FORMAT_SGB) {
+#if SGB_OQPSK
+        start_transmission_sgb(&s->sgb.frame);
+#endif
+    } else {
+        bch_inject_errors((packed_frame_t*)&beacon_frame);  // BCH ERR: back buffer only, cache stays clean
+        start_transmission(&beacon_frame);  // Slot swap only, no copy
+    }
+    telemetry_tag_burst(head, p->format, p->use_gps);
+
+    beacon_prepared = -1;
+    beacon_last = (int8_t)head;
+    s->next_due = now + beacon_jittered_period(p->base_period_ms);
+    beacon_slot_free = now + BEACON_SLOT_MS;
+
+    DEBUG_LOG_FLUSH("Burst: profile ");
+    debug_print_uint16(head);
+    DEBUG_LOG_FLUSH(" ID 0x");
+    debug_print_hex32(p->beacon_id);
+    if (p->format == BEACON_FORMAT_SGB) DEBUG_LOG_FLUSH(" T.018");
+    DEBUG_LOG_FLUSH(p->mode == BEACON_MODE_TEST ? " TEST\r\n" : " EXERCISE\r\n");
+    return 1;
+}
@@ -0,0 +1,54 @@
+/* beacon_profiles.h - Multi-beacon profiles and EDF burst scheduling */
+#ifndef BEACON_PROFILES_H
+#define BEACON_PROFILES_H
+
+#include "system_definitions.h"
+#include "protocol_data.h"
+#include "sgb_frame.h"
+
+// =============================
+// Configuration
+// =============================
+#ifndef BEACON_PROFILES_ACTIVE
+#define BEACON_PROFILES_ACTIVE   1      // Profiles on air (1 = single beacon, follows RB12)
+#endif
+#define BEACON_PROFILES_MAX      4      // Entries in beacon_profile_table
+#define BEACON_JITTER_PERMILLE   50     // T.001 randomised period: base +/-5%
+#define BEACON_GUARD_MS          200    // Minimum silence between two bursts
+#define BEACON_TX_MAX_MS         (SGB_TX_DURATION_MS > TOTAL_TX_DURATION_MS ? \
+                                  SGB_TX_DURATION_MS : TOTAL_TX_DURATION_MS)
+#define BEACON_SLOT_MS           (BEACON_TX_MAX_MS + BEACON_GUARD_MS)
+#define BEACON_PREPARE_PERIOD_MS 20     // Back buffer refresh (GPS, switch)
+#define BEACON_MODE_SWITCH       0xFF   // Mode taken from RB12 (primary beacon)
+
+// Static description of one simulated beacon
+typedef struct {
+    uint32_t beacon_id;         // 26-bit ID (bits 41-66)
+    uint16_t country;           // 10-bit country code (bits 27-36)
+    uint8_t mode;               // BEACON_MODE_TEST / EXERCISE / SWITCH
+    uint8_t power;              // RF_POWER_LOW / RF_POWER_HIGH
+    uint8_t use_gps;            // 1 = current GPS fix, 0 = fixed position below
+    int32_t latitude;           // 1/10000 minute
+    int32_t longitude;          // 1/10000 minute
+    int32_t altitude;           // Decimeters
+    uint32_t base_period_ms;    // Mean repetition period before jitter
+    uint8_t format;             // BEACON_FORMAT_FGB (T.001) / BEACON_FORMAT_SGB (T.018)
+} beacon_profile_t;
+
+_Static_assert(BEACON_PROFILES_ACTIVE >= 1 && BEACON_PROFILES_ACTIVE <= BEACON_PROFILES_MAX,
+               "BEACON_PROFILES_ACTIVE out of range");
+
+// =============================
+// Prototypes
+// =============================
+beacon_frame_type_t get_frame_type_from_switch(void);
+void beacon_sched_init(uint32_t now);
+void beacon_sched_prepare(void);        // Task: pre-build the next burst's frame
+uint8_t beacon_sched_start(void);       // Start the earliest due burst (tx idle)
+uint32_t beacon_sched_next_due(void);   // Earliest deadline over all profiles
+int8_t beacon_sched_last(void);         // Profile of the last burst (-1 = none)
+void beacon_sched_invalidate(void);     // Back buffer overwritten: prepare again
+uint8_t beacon_sched_set_format(uint8_t format);  // Primary beacon T.001/T.018, 0 = refused
+uint8_t beacon_sched_format(void);
+
+#endif /* BEACON_PROFILES_H */
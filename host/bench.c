@@ -0,0 +1,320 @@
+/* bench.c - Host benchmark of the frame and modulation pipeline
+ * Runs the frame encoder, BCH validation and the Timer1 sample ISR over a
+ * randomised lat/lon/alt corpus and reports the cost per operation.
+ * Exits non-zero if a built frame fails its BCH check, the table and
+ * bit-serial BCH disagree, or a burst does not run to completion.
+ *
+ *   ./bench [corpus_size] [bursts] [seed] [-v]
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_comms.h"
+#include "system_debug.h"
+#include "protocol_data.h"
+#include "sgb_frame.h"
+#include <time.h>
+
+#define BENCH_CORPUS_DEFAULT    100000
+#define BENCH_BURSTS_DEFAULT    20
+#define BENCH_SEED_DEFAULT      0x12345678UL
+#define BENCH_ISR_LIMIT         (4 * BURST_SAMPLES)     // Runaway burst guard
+
+extern uint8_t host_log_enabled;
+
+typedef struct {
+    int32_t lat;                // 1/10000 minute
+    int32_t lon;
+    int32_t alt;                // Decimeters
+} bench_pos_t;
+
+static uint32_t bench_rand_state;
+
+static uint32_t bench_rand(void) {
+    uint32_t x = bench_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_rand_state = x;
+    return x;
+}
+
+static int32_t bench_rand_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(bench_rand() % (uint32_t)(hi - lo + 1));
+}
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Whole globe, altitude -400 m .. 16 000 m
+static void bench_fill_corpus(bench_pos_t *corpus, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        corpus[i].lat = bench_rand_range(-90L * GPS_UNITS_PER_DEGREE + 1, 90L * GPS_UNITS_PER_DEGREE - 1);
+        corpus[i].lon = bench_rand_range(-180L * GPS_UNITS_PER_DEGREE, 180L * GPS_UNITS_PER_DEGREE - 1);
+        corpus[i].alt = bench_rand_range(-4000L, 160000L);
+    }
+}
+
+static void bench_report(const char *name, double ns, uint32_t count, const char *unit) {
+    printf("%-30s %9.1f ns/%s\n", name, ns / (double)count, unit);
+}
+
+// =============================
+// Frame pipeline
+// =============================
+static uint32_t bench_frames(const bench_pos_t *corpus, uint32_t n) {
+    static frame_cache_t cache;
+    static packed_frame_t *built;
+    uint32_t failures = 0;
+    volatile uint32_t sink = 0;
+    double t0;
+
+    built = malloc(n * sizeof(packed_frame_t));
+    if (built == NULL) return n;
+    frame_cache_init(&cache, BEACON_DEFAULT_ID, COUNTRY_CODE_FRANCE);
+
+    // Incremental encode: position + PDF-2 + both BCHs when they change
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        frame_cache_update(&cache, BEACON_MODE_EXERCISE, corpus[i].lat, corpus[i].lon, corpus[i].alt);
+        built[i] = cache.frame;
+    }
+    bench_report("encode (cache update)", bench_now_ns() - t0, n, "frame");
+
+    // Full rebuild: header + everything
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        frame_cache_invalidate(&cache);
+        frame_cache_update(&cache, BEACON_MODE_EXERCISE, corpus[i].lat, corpus[i].lon, corpus[i].alt);
+        sink += cache.frame.w[8];
+    }
+    bench_report("build (full rebuild)", bench_now_ns() - t0, n, "frame");
+
+    // Validation of every built frame
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        if (!frame_check_bch(&built[i])) failures++;
+    }
+    bench_report("validate (BCH1 + BCH2)", bench_now_ns() - t0, n, "frame");
+    if (failures) printf("  %lu frames failed validation\n", (unsigned long)failures);
+
+    // Table-driven BCH against the bit-serial reference
+    uint32_t mismatches = 0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        sink += compute_bch1(get_bit_field(&built[i], 25, 61));
+        sink += compute_bch2((uint32_t)get_bit_field(&built[i], 107, 26));
+    }
+    bench_report("compute_bch1+2 (tables)", bench_now_ns() - t0, n, "frame");
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t pdf1 = get_bit_field(&built[i], 25, 61);
+        uint32_t pdf2 = (uint32_t)get_bit_field(&built[i], 107, 26);
+        uint32_t ref1 = compute_bch(pdf1, BCH1_DATA_BITS, BCH1_POLY, BCH1_DEGREE, BCH1_POLY_MASK);
+        uint32_t ref2 = compute_bch(pdf2, BCH2_DATA_BITS, BCH2_POLY, BCH2_DEGREE, BCH2_POLY_MASK);
+        if (ref1 != compute_bch1(pdf1) || ref2 != compute_bch2(pdf2)) mismatches++;
+        if (ref2 > BCH2_POLY_MASK) mismatches++;     // Must fit the 12-bit field
+    }
+    bench_report("compute_bch (serial + check)", bench_now_ns() - t0, n, "frame");
+    if (mismatches) printf("  %lu table/serial BCH mismatches\n", (unsigned long)mismatches);
+
+    // Decoder: t errors in each codeword, corrected back to the built frame
+    uint32_t uncorrected = 0;
+    bch_set_error_injection(BCH1_T, BCH2_T);
+    for (uint32_t i = 0; i < n; i++) {
+        bch_inject_errors(&built[i]);
+    }
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        if (bch1_correct(&built[i]) != BCH1_T || bch2_correct(&built[i]) != BCH2_T ||
+            !frame_check_bch(&built[i])) uncorrected++;
+    }
+    bench_report("decode (3 + 2 bit errors)", bench_now_ns() - t0, n, "frame");
+    bch_set_error_injection(0, 0);
+    if (uncorrected) printf("  %lu frames not corrected\n", (unsigned long)uncorrected);
+    mismatches += uncorrected;
+
+    free(built);
+    (void)sink;
+    return failures + mismatches;
+}
+
+// =============================
+// Second generation (T.018)
+// =============================
+// Encode + BCH over the corpus, then one burst rendered with levels 0/1:
+// the first 64 chips of I and Q against the T.018 normal-mode sequences,
+// then the whole burst chip by chip against a bit-serial x^23+x^18+1
+// LFSR started from those chips (not from SGB_PRN_SEED_I).
+static const uint16_t sgb_kat_i[4] = { 0x8000, 0x0108, 0x4212, 0x84A1 };
+static const uint16_t sgb_kat_q[4] = { 0x2C6A, 0x12CE, 0xA12C, 0xFA96 };  // I chips 64-127
+
+static uint32_t bench_sgb(const bench_pos_t *corpus, uint32_t n) {
+    static sgb_cache_t cache;
+    static uint8_t ref[SGB_CHIPS_PER_CHANNEL + SGB_PRN_Q_OFFSET_CHIPS];
+    static uint16_t i_buf[2 * SGB_CHIPS_PER_CHANNEL + 32], q_buf[2 * SGB_CHIPS_PER_CHANNEL + 32];
+    sgb_modulator_t mod = { .level_i = { 0, 1 }, .level_q = { 0, 1 }, .idle_i = 2, .idle_q = 2 };
+    uint32_t failures = 0, errors = 0;
+    double t0;
+
+    sgb_cache_init(&cache, SGB_TAC_TRAINING, BEACON_DEFAULT_ID & 0x3FFF, COUNTRY_CODE_FRANCE);
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        sgb_cache_update(&cache, BEACON_MODE_EXERCISE, corpus[i].lat, corpus[i].lon, corpus[i].alt);
+        if (!sgb_frame_check_bch(&cache.frame)) failures++;
+    }
+    bench_report("sgb encode (BCH + check)", bench_now_ns() - t0, n, "frame");
+    if (failures) printf("  %lu T.018 frames failed validation\n", (unsigned long)failures);
+
+    for (uint32_t k = 0; k < sizeof(ref); k++) {
+        ref[k] = (k < 23) ? (uint8_t)((sgb_kat_i[k >> 4] >> (15 - (k & 15))) & 1) : ref[k - 5] ^ ref[k - 23];
+    }
+    t0 = bench_now_ns();
+    sgb_mod_init(&mod, &cache.frame);
+    for (uint32_t k = 0; k < sizeof(i_buf) / sizeof(i_buf[0]); k += 32) {
+        sgb_mod_render(&mod, &i_buf[k], &q_buf[k], 32);     // Half-buffer granularity
+    }
+    bench_report("sgb render (I + Q)", bench_now_ns() - t0, 2 * SGB_CHIPS_PER_CHANNEL, "sample");
+
+    // Preamble bits are 0: the first chips are the bare PRN
+    for (uint32_t j = 0; j < 64; j++) {
+        uint8_t kat_i = (uint8_t)((sgb_kat_i[j >> 4] >> (15 - (j & 15))) & 1);
+        uint8_t kat_q = (uint8_t)((sgb_kat_q[j >> 4] >> (15 - (j & 15))) & 1);
+        if (i_buf[2 * j] != kat_i || q_buf[2 * j + 1] != kat_q) errors++;
+    }
+    if (errors) printf("  T.018 PRN start differs from the normal-mode I/Q sequences\n");
+
+    for (uint32_t j = 0; j < SGB_CHIPS_PER_CHANNEL; j++) {
+        uint16_t bit = (uint16_t)(2 * (j / SGB_CHIPS_PER_BIT));
+        if (i_buf[2 * j] != (ref[j] ^ SGB_TX_BIT(cache.frame, bit)) || i_buf[2 * j + 1] != i_buf[2 * j] ||
+            q_buf[2 * j + 1] != (ref[j + SGB_PRN_Q_OFFSET_CHIPS] ^ SGB_TX_BIT(cache.frame, bit + 1)) ||
+            q_buf[2 * j + 2] != q_buf[2 * j + 1]) errors++;
+    }
+    if (q_buf[0] != 2 || i_buf[2 * SGB_CHIPS_PER_CHANNEL] != 2) errors++;
+    if (errors) printf("  %lu T.018 chips differ from the reference PRN\n", (unsigned long)errors);
+    return failures + errors;
+}
+
+// =============================
+// Sample ISR
+// =============================
+// Decode the RLE capture of the first burst; recording starts one tick
+// after the first ramp-up sample
+static uint32_t bench_wave_check(uint32_t expected, uint32_t live_hash) {
+#if WAVE_CAPTURE
+    uint16_t words, lost;
+    const uint16_t *buf = wave_capture_get(&words, &lost);
+    uint32_t hash = 2166136261UL;
+    uint32_t decoded = 0;
+
+    if (buf == NULL) {
+        printf("  wave capture not complete\n");
+        return 1;
+    }
+    for (uint16_t i = 0; i < words; i++) {
+        uint16_t run = (buf[i] >> WAVE_RUN_SHIFT) + 1;
+        for (uint16_t r = 0; r < run; r++) {
+            hash = (hash ^ (buf[i] & WAVE_CODE_MASK)) * 16777619UL;
+        }
+        decoded += run;
+    }
+    printf("  wave capture %u words (%u max), %lu samples, %u lost\n", words,
+           WAVE_CAPTURE_WORDS, (unsigned long)decoded, lost);
+    wave_capture_release();
+    if (lost) return 0;     // Truncated (high OVERSAMPLING): nothing to compare
+    if (decoded != expected || hash != live_hash) {
+        printf("  wave capture does not match the DAC stream\n");
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+static uint32_t bench_isr(const bench_pos_t *corpus, uint32_t n, uint32_t bursts) {
+    static frame_cache_t cache;
+    uint32_t failures = 0;
+    uint32_t samples_total = 0;
+    uint32_t samples_first = 0;
+    uint32_t dac_hash = 2166136261UL;       // FNV-1a over DAC1DATH
+    uint32_t live_hash = 2166136261UL;      // Same, over the samples the capture sees
+    double ns_total = 0;
+
+    ramp_samples = RAMP_SAMPLES_DEFAULT;
+    init_q_channel_table();
+    init_q_transition_table();
+    frame_cache_init(&cache, BEACON_DEFAULT_ID, COUNTRY_CODE_FRANCE);
+
+    for (uint32_t b = 0; b < bursts; b++) {
+        const bench_pos_t *p = &corpus[b % n];
+        frame_cache_update(&cache, BEACON_MODE_EXERCISE, p->lat, p->lon, p->alt);
+        memcpy((void *)&beacon_frame, &cache.frame, sizeof(packed_frame_t));
+        if (b == 0) wave_capture_arm();
+        start_transmission(&beacon_frame);
+
+        uint32_t samples = 0;
+        double t0 = bench_now_ns();
+        do {
+            _T1Interrupt();
+            dac_hash = (dac_hash ^ DAC1DATH) * 16777619UL;
+            if (b == 0 && samples > 0) live_hash = (live_hash ^ DAC1DATH) * 16777619UL;
+        } while (tx_phase != IDLE_STATE && ++samples < BENCH_ISR_LIMIT);
+        ns_total += bench_now_ns() - t0;
+        samples++;
+
+        if (b == 0) {
+            samples_first = samples;
+            failures += bench_wave_check(samples - 1, live_hash);
+        }
+        if (samples >= BENCH_ISR_LIMIT || samples < BURST_SAMPLES || samples != samples_first) {
+            printf("  burst %lu: %lu samples (expected %lu)\n", (unsigned long)b,
+                   (unsigned long)samples, (unsigned long)samples_first);
+            failures++;
+        }
+        samples_total += samples;
+    }
+
+    bench_report("isr (_T1Interrupt)", ns_total, samples_total, "sample");
+    printf("  %lu bursts x %lu samples, budget %lu ns/sample on target, DAC hash 0x%08lX\n",
+           (unsigned long)bursts, (unsigned long)samples_first,
+           (unsigned long)(1000000000UL / SAMPLE_RATE_HZ), (unsigned long)dac_hash);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    uint32_t corpus_size = BENCH_CORPUS_DEFAULT;
+    uint32_t bursts = BENCH_BURSTS_DEFAULT;
+    uint32_t seed = BENCH_SEED_DEFAULT;
+    uint8_t arg = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            host_log_enabled = 1;
+            continue;
+        }
+        uint32_t v = (uint32_t)strtoul(argv[i], NULL, 0);
+        if (arg == 0) corpus_size = v;
+        else if (arg == 1) bursts = v;
+        else if (arg == 2) seed = v;
+        arg++;
+    }
+    if (corpus_size == 0) corpus_size = 1;
+    bench_rand_state = seed ? seed : BENCH_SEED_DEFAULT;
+
+    bench_pos_t *corpus = malloc(corpus_size * sizeof(bench_pos_t));
+    if (corpus == NULL) return 2;
+    bench_fill_corpus(corpus, corpus_size);
+
+    printf("corpus %lu positions, seed 0x%08lX, OVERSAMPLING %d, TRANSITION_SHAPING %d\n",
+           (unsigned long)corpus_size, (unsigned long)seed, OVERSAMPLING, TRANSITION_SHAPING);
+
+    uint32_t failures = bench_frames(corpus, corpus_size);
+    failures += bench_sgb(corpus, corpus_size);
+    failures += bench_isr(corpus, corpus_size, bursts);
+
+    free(corpus);
+    printf("%s\n", failures ? "FAIL" : "OK");
+    return failures ? 1 : 0;
+}
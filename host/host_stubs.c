@@ -0,0 +1,54 @@
+/* host_stubs.c - Host replacements for system_debug.c and rf_interface.c
+ * Debug output goes to stdout when host_log_enabled is set, the RF chain
+ * is always "ready" so the sample ISR runs straight through a burst.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_debug.h"
+#include "rf_interface.h"
+
+uint8_t host_log_enabled = 0;
+
+// =============================
+// system_debug.c
+// =============================
+volatile debug_flags_t debug_flags;
+volatile char rxQueue[UART_BUFFER_SIZE];
+volatile uint16_t rxHead = 0;
+volatile uint16_t rxTail = 0;
+volatile uint8_t rxOverflowed = 0;
+
+void system_debug_init(void) {}
+void init_comm_uart(void) {}
+void debug_full_flush(void) {}
+void isr_trace_push(uint8_t aux, uint8_t env, uint16_t dac) {}
+void debug_push_bin(const void *src, uint16_t len) { if (host_log_enabled) fwrite(src, 1, len, stdout); }
+void debug_wait_room(uint16_t len) { (void)len; }
+uint16_t debug_get_tx_dropped(void) { return 0; }
+
+void debug_print_char(char c)             { if (host_log_enabled) putchar(c); }
+void debug_print_str(const char *str)     { if (host_log_enabled) fputs(str, stdout); }
+void debug_print_float(double value, int precision) { if (host_log_enabled) printf("%.*f", precision, value); }
+void debug_print_uint16(uint16_t value)   { if (host_log_enabled) printf("%u", value); }
+void debug_print_int32(int32_t value)     { if (host_log_enabled) printf("%ld", (long)value); }
+void debug_print_uint32(uint32_t value)   { if (host_log_enabled) printf("%lu", (unsigned long)value); }
+void debug_print_hex(uint8_t value)       { if (host_log_enabled) printf("%02X", value); }
+void debug_print_hex16(uint16_t value)    { if (host_log_enabled) printf("%04X", value); }
+void debug_print_hex24(uint32_t value)    { if (host_log_enabled) printf("%06lX", (unsigned long)value); }
+void debug_print_hex32(uint32_t value)    { if (host_log_enabled) printf("%08lX", (unsigned long)value); }
+void debug_print_hex64(uint64_t value)    { if (host_log_enabled) printf("%016llX", (unsigned long long)value); }
+
+// =============================
+// rf_interface.c
+// =============================
+void rf_initialize_all_modules(void) {}
+void rf_set_power_level(uint8_t mode) {}
+void rf_control_amplifier_chain(uint8_t state) {}
+uint8_t rf_chain_ready(void) { return 1; }
+void rf_channel_poll_switch(void) {}
+uint8_t rf_adf4351_get_channel(void) { return RF_CHANNEL_DEFAULT; }
+uint32_t rf_adf4351_channel_khz(uint8_t ch) { return 403000UL; }
+uint16_t rf_adf4351_lock_time_us(void) { return 0; }
+uint8_t rf_adf4351_locked(void) { return 1; }
+uint16_t rf_adf4351_lock_losses(void) { return 0; }
+uint8_t rf_adf4351_relock_take(uint16_t *lock_us) { return 0; }
@@ -0,0 +1,7 @@
+/* sfr.c - Storage for the host SFR shim (see shim/sfr_list.h) */
+#include <xc.h>
+
+#define SFR(n)      volatile uint16_t n;
+#define SFRBITS(n)  volatile host_sfrbits_t n;
+#define SFRFIELD(n)
+#include "sfr_list.h"
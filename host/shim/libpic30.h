@@ -0,0 +1,8 @@
+/* libpic30.h - Host stand-in: busy-wait delays compile away */
+#ifndef HOST_LIBPIC30_H
+#define HOST_LIBPIC30_H
+
+#define __delay_ms(x)   ((void)(x))
+#define __delay_us(x)   ((void)(x))
+
+#endif /* HOST_LIBPIC30_H */
@@ -0,0 +1,39 @@
+/* sfr_list.h - SFRs touched by protocol_data.c / system_comms.c on the host
+ * X-macro list: SFR(name) for 16-bit registers, SFRBITS(name) for the
+ * xxxbits views, SFRFIELD(name) for every bit field used through them.
+ * Add an entry when the firmware starts using a new register.
+ */
+
+// 16-bit registers
+SFR(OSCCON) SFR(PLLFBD) SFR(ANSELA) SFR(ANSELB)
+SFR(ANSELD) SFR(DAC1CONH) SFR(DAC1CONL) SFR(DACCTRL1L)
+SFR(DACCTRL2H) SFR(DACCTRL2L) SFR(DAC1DATH) SFR(T1CON)
+SFR(TMR1) SFR(PR1) SFR(CCP1CON1L) SFR(CCP1CON1H)
+SFR(CCP1CON2L) SFR(CCP1CON2H) SFR(CCP1TMRL) SFR(CCP1PRL)
+SFR(ADCON1L) SFR(ADCON1H) SFR(ADCON2L) SFR(ADCON2H)
+SFR(ADCON3L) SFR(ADCON3H) SFR(ADCBUF0) SFR(PCLKCON)
+SFR(PG1CONL) SFR(PG1CONH) SFR(PG1IOCONH) SFR(PG1PER)
+SFR(PG1PHASE) SFR(PG1DC)
+
+// Bit views
+SFRBITS(OSCCONbits) SFRBITS(CLKDIVbits) SFRBITS(PLLDIVbits) SFRBITS(TRISAbits)
+SFRBITS(LATAbits) SFRBITS(TRISBbits) SFRBITS(LATBbits) SFRBITS(ANSELDbits)
+SFRBITS(TRISDbits) SFRBITS(LATDbits) SFRBITS(CNPDBbits) SFRBITS(ANSELAbits)
+SFRBITS(ANSELBbits) SFRBITS(DAC1CONLbits) SFRBITS(DACCTRL1Lbits) SFRBITS(T1CONbits)
+SFRBITS(IPC0bits) SFRBITS(IFS0bits) SFRBITS(IEC0bits) SFRBITS(IPC1bits)
+SFRBITS(CCP1CON1Lbits) SFRBITS(ADCON1Hbits) SFRBITS(ADCON3Hbits) SFRBITS(ADCORE0Lbits)
+SFRBITS(ADCORE0Hbits) SFRBITS(ADTRIG0Lbits) SFRBITS(ADCON5Hbits) SFRBITS(ADCON1Lbits)
+SFRBITS(ADCON5Lbits) SFRBITS(ADCON3Lbits) SFRBITS(ADSTATLbits) SFRBITS(PG1CONLbits)
+SFRBITS(PG1IOCONHbits) SFRBITS(PG1EVTLbits)
+
+// Bit fields (one flat struct serves every view)
+SFRFIELD(OSWEN) SFRFIELD(PLLPRE) SFRFIELD(POST1DIV) SFRFIELD(POST2DIV) SFRFIELD(LOCK) SFRFIELD(TRISA3)
+SFRFIELD(LATA3) SFRFIELD(TRISB15) SFRFIELD(LATB15) SFRFIELD(TRISB11) SFRFIELD(LATB11) SFRFIELD(ANSELD10)
+SFRFIELD(TRISD10) SFRFIELD(LATD10) SFRFIELD(TRISB12) SFRFIELD(CNPDB12) SFRFIELD(TRISB13) SFRFIELD(CNPDB13)
+SFRFIELD(ANSELA3) SFRFIELD(TRISB0) SFRFIELD(ANSELB0) SFRFIELD(LATB0) SFRFIELD(DACEN) SFRFIELD(DACOEN)
+SFRFIELD(DACON) SFRFIELD(TCKPS) SFRFIELD(TCS) SFRFIELD(T1IP) SFRFIELD(T1IF) SFRFIELD(T1IE)
+SFRFIELD(TON) SFRFIELD(CCT1IP) SFRFIELD(CCT1IF) SFRFIELD(CCT1IE) SFRFIELD(CCPON) SFRFIELD(ANSELA0)
+SFRFIELD(TRISA0) SFRFIELD(FORM) SFRFIELD(CLKSEL) SFRFIELD(CLKDIV) SFRFIELD(SAMC) SFRFIELD(RES)
+SFRFIELD(ADCS) SFRFIELD(TRGSRC0) SFRFIELD(WARMTIME) SFRFIELD(ADON) SFRFIELD(C0PWR) SFRFIELD(C0RDY)
+SFRFIELD(C0EN) SFRFIELD(SWCTRG) SFRFIELD(AN0RDY) SFRFIELD(MODSEL) SFRFIELD(PENH) SFRFIELD(UPDTRG)
+SFRFIELD(TRISB14) SFRFIELD(ON)
@@ -0,0 +1,50 @@
+/* xc.h - Host stand-in for the XC16 device header (simulation build only)
+ * SFRs are plain RAM variables (defined in host/sfr.c), interrupt and PSV
+ * attributes compile away, interrupt masking is a no-op.
+ */
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+
+// =============================
+// Attributes and builtins
+// =============================
+#define interrupt                       unused
+#define __interrupt__                   unused
+#define auto_psv                        unused
+#define __auto_psv__                    unused
+#define no_auto_psv                     unused
+#define __no_auto_psv__                 unused
+#define __builtin_disable_interrupts()  ((void)0)
+#define __builtin_enable_interrupts()   ((void)0)
+#define __builtin_write_OSCCONH(x)      ((void)(x))
+#define __builtin_write_OSCCONL(x)      ((void)(x))
+#define __builtin_nop()                 ((void)0)
+#define Idle()                          ((void)0)
+#define Sleep()                         ((void)0)
+#define ClrWdt()                        ((void)0)
+
+// =============================
+// SFRs (list in sfr_list.h)
+// =============================
+// One flat bit struct serves every xxxbits view
+typedef struct {
+#define SFR(n)
+#define SFRBITS(n)
+#define SFRFIELD(n) unsigned n;
+#include "sfr_list.h"
+#undef SFR
+#undef SFRBITS
+#undef SFRFIELD
+} host_sfrbits_t;
+
+#define SFR(n)      extern volatile uint16_t n;
+#define SFRBITS(n)  extern volatile host_sfrbits_t n;
+#define SFRFIELD(n)
+#include "sfr_list.h"
+#undef SFR
+#undef SFRBITS
+#undef SFRFIELD
+
+#endif /* HOST_XC_H */
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""wave_export.py - Decode WAVE captures from a raw UART2 dump
+
+Finds every WAVE frame streamed by wave_capture_stream() in a binary log
+of the debug UART, checks it and writes the DAC sample stream as CSV
+(sample, time_s, dac_code) and as a mono 16-bit WAV at the sample rate.
+
+    python3 host/wave_export.py uart2.bin [output_prefix]
+"""
+import struct
+import sys
+import wave
+
+HEADER = struct.Struct("<4sBBIHH")      # magic, version, oversampling, rate, words, lost
+CODE_MASK = 0x0FFF
+RUN_SHIFT = 12
+DAC_MID = 2048
+
+
+def frames(data):
+    pos = data.find(b"WAVE")
+    while pos >= 0:
+        if pos + HEADER.size <= len(data):
+            magic, version, osr, rate, words, lost = HEADER.unpack_from(data, pos)
+            end = pos + HEADER.size + 2 * words + 2
+            if version == 1 and end <= len(data):
+                rle = struct.unpack_from("<%dH" % words, data, pos + HEADER.size)
+                (checksum,) = struct.unpack_from("<H", data, end - 2)
+                if sum(rle) & 0xFFFF == checksum:
+                    yield osr, rate, lost, rle
+                    pos = data.find(b"WAVE", end)
+                    continue
+        pos = data.find(b"WAVE", pos + 1)
+
+
+def decode(rle):
+    samples = []
+    for w in rle:
+        samples.extend([w & CODE_MASK] * ((w >> RUN_SHIFT) + 1))
+    return samples
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    prefix = sys.argv[2] if len(sys.argv) > 2 else "wave"
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    count = 0
+    for osr, rate, lost, rle in frames(data):
+        samples = decode(rle)
+        name = "%s_%d" % (prefix, count)
+        with open(name + ".csv", "w") as f:
+            f.write("sample,time_s,dac_code\n")
+            for i, code in enumerate(samples):
+                f.write("%d,%.7f,%d\n" % (i, i / rate, code))
+        with wave.open(name + ".wav", "wb") as w:
+            w.setnchannels(1)
+            w.setsampwidth(2)
+            w.setframerate(rate)
+            w.writeframes(b"".join(struct.pack("<h", (c - DAC_MID) * 16) for c in samples))
+        print("%s: %d samples @ %d Hz (%dx), %d words%s" % (
+            name, len(samples), rate, osr, len(rle),
+            ", %d samples lost (buffer full)" % lost if lost else ""))
+        count += 1
+
+    if count == 0:
+        sys.exit("no valid WAVE frame found")
+
+
+if __name__ == "__main__":
+    main()
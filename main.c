@@ -5,41 +5,105 @@
 #include "system_comms.h"
 #include "protocol_data.h"  // Ajout pour les fonctions de trame
 #include "rf_interface.h"   // Pour les fonctions RF
+#include "system_scheduler.h"
+#include "beacon_profiles.h"  // Profils multi-balises + EDF
+#include "tx_telemetry.h"    // Statistiques par burst (STATS)
 
 // D�clarations externes
-extern volatile uint32_t millis_counter;
 extern volatile tx_phase_t tx_phase;
-extern volatile uint8_t beacon_frame[];
 
-// D�claration de la fonction start_beacon_frame
-void start_beacon_frame(beacon_frame_type_t frame_type);
+// =============================
+// Taches du scheduler
+// =============================
+static int8_t tx_task_id = -1;
 
-// Lecture du switch de sélection mode
-beacon_frame_type_t get_frame_type_from_switch(void) {
-    // RB12 = 0 (pull-down) → TEST mode
-    // RB12 = 1 (switch pressed) → EXERCISE mode
-    return PORTBbits.RB12 ? BEACON_EXERCISE_FRAME : BEACON_TEST_FRAME;
+#if LOW_POWER_IDLE
+// =============================
+// Veille entre bursts
+// =============================
+static int8_t wake_task_id = -1;
+static uint8_t power_parked = 0;
+static uint32_t power_wake_due = 0;                 // Echeance du reveil (ms)
+static uint16_t power_wake_latency_max = 0;         // Latence mesuree (ms)
+static uint16_t power_late_wakes = 0;               // Reveils apres l'echeance TX
+static uint16_t power_lead_ms = POWER_WAKE_MARGIN_MS +
+                                ((RF_IDLE_HOLD_MODE == RF_HOLD_POWER_DOWN) ? RF_PLL_RELOCK_MS : 0);
+
+static void power_wake(void) {
+    uint32_t now = sched_now();
+    uint16_t latency = (uint16_t)(now - power_wake_due);
+    
+    timer1_unpark();
+    rf_adf4351_resume();
+    power_parked = 0;
+    
+    // Avance adaptee a la pire latence observee (Idle -> tache)
+    if (latency > power_wake_latency_max) {
+        power_wake_latency_max = latency;
+        power_lead_ms = power_wake_latency_max + POWER_WAKE_MARGIN_MS +
+                        ((RF_IDLE_HOLD_MODE == RF_HOLD_POWER_DOWN) ? RF_PLL_RELOCK_MS : 0);
+    }
 }
 
-uint8_t should_transmit_beacon(void) {
-    uint8_t phase;
-    uint32_t current_millis, last_tx;
+static void task_power_wake(void) {
+    if (power_parked) power_wake();
+}
+
+// Parking: burst termine, chaine RF coupee, prochaine echeance assez loin
+static void task_power_park(void) {
+    if (power_parked || tx_phase != IDLE_STATE || rf_chain_get_state() != RF_CHAIN_OFF) return;
     
-    // Lecture atomique des variables partag�es
-    __builtin_disable_interrupts();
-    phase = tx_phase;
-    current_millis = millis_counter;
-    last_tx = last_tx_time;
-    __builtin_enable_interrupts();
+    uint32_t now = sched_now();
+    uint32_t tx_due = beacon_sched_next_due();
+    if ((int32_t)(tx_due - now) <= (int32_t)(power_lead_ms + POWER_PARK_MIN_MS)) return;
+    
+    rf_adf4351_hold(RF_IDLE_HOLD_MODE);
+    timer1_park();
+    power_parked = 1;
+    power_wake_due = tx_due - power_lead_ms;
+    sched_set_deadline(wake_task_id, power_wake_due);
+}
+#endif
+
+// Declenchement TX a l'echeance EDF du prochain profil
+static void task_tx_trigger(void) {
+#if LOW_POWER_IDLE
+    if (power_parked) {         // Reveil trop tardif : sortie immediate
+        power_late_wakes++;
+        power_wake();
+    }
+#endif
+    if (tx_phase != IDLE_STATE) {
+        sched_set_deadline(tx_task_id, sched_now() + 1);  // Burst en cours
+        return;
+    }
+    if ((int32_t)(sched_now() - beacon_sched_next_due()) >= 0) {
+        beacon_sched_start();   // Trame deja preparee : simple echange de slot
+    }
+    
+    // Prochaine echeance ; trame rejetee : profil repousse d'une periode
+    sched_set_deadline(tx_task_id, beacon_sched_next_due());
+}
 
-    return (phase == IDLE_STATE) && 
-           ((current_millis - last_tx) >= tx_interval_ms);
+static void task_status(void) {
+    DEBUG_LOG_FLUSH("Status: phase=");
+    debug_print_uint16(tx_phase);
+    DEBUG_LOG_FLUSH(" profile=");
+    debug_print_int16(beacon_sched_last());
+#if LOW_POWER_IDLE
+    DEBUG_LOG_FLUSH(" wake_lat=");
+    debug_print_uint16(power_wake_latency_max);
+    DEBUG_LOG_FLUSH("ms lead=");
+    debug_print_uint16(power_lead_ms);
+    DEBUG_LOG_FLUSH("ms late=");
+    debug_print_uint16(power_late_wakes);
+#endif
+    DEBUG_LOG_FLUSH("\r\n");
 }
 
 int main(void) {
 	__builtin_disable_interrupts();
     system_init();
-    set_tx_interval(5000);  // Initial interval (will be adjusted by frame type)
     __builtin_enable_interrupts();
     
     DEBUG_LOG_FLUSH("System initialized\r\n");
@@ -49,41 +113,28 @@ int main(void) {
     beacon_frame_type_t frame_type = get_frame_type_from_switch();
     DEBUG_LOG_FLUSH("Starting transmission - Mode: ");
     DEBUG_LOG_FLUSH(frame_type == BEACON_TEST_FRAME ? "TEST\r\n" : "EXERCISE\r\n");
-    start_beacon_frame(frame_type);  // Generate according to switch
+    cs_t001_full_compliance_check();  // Validation protocolaire (une fois)
+
+    uint32_t now = sched_now();
+    beacon_sched_init(now);           // Profil 0 du immediatement, autres decales
+    scheduler_init();
+    tx_task_id = scheduler_add(task_tx_trigger, SCHED_ONESHOT, beacon_sched_next_due());
+    scheduler_add(beacon_sched_prepare, BEACON_PREPARE_PERIOD_MS, now);  // Trame du prochain burst
+    scheduler_add(rf_chain_task, 1, now);              // RF power sequencer
+    scheduler_add(gps_uart_task, 5, now);              // NMEA bytes from UART1
+    scheduler_add(isr_trace_drain, 5, now);            // Traces ISR -> UART2
+    scheduler_add(wave_capture_stream, 50, now);       // Capture DAC -> UART2 (WAVE)
+    scheduler_add(process_uart_commands, 20, now);     // Commandes debug
+    scheduler_add(task_status, 1000, now + 1000);      // Rapport d'etat
+    scheduler_add(telemetry_task, TELEMETRY_TASK_MS, now);  // Cloture des records de burst
+#if LOW_POWER_IDLE
+    scheduler_add(task_power_park, 10, now);           // Veille entre bursts
+    wake_task_id = scheduler_add(task_power_wake, SCHED_ONESHOT, now);
+    sched_disarm(wake_task_id);
+#endif
 
     while(1) {
-		process_uart_commands();  // Handle commands
-		
-        uint32_t current_time;
-        __builtin_disable_interrupts();
-        current_time = millis_counter;
-        __builtin_enable_interrupts();
-        
-        // Transfert des logs UART
-        while (isr_log_tail != isr_log_head) {
-            while (U2STAHbits.UTXBF); 
-            U2TXREG = isr_log_buf[isr_log_tail];
-            isr_log_tail = (isr_log_tail + 1) % ISR_LOG_BUF_SIZE;
-        }
-        
-        // Periodic transmission trigger (read switch each time)
-        if (should_transmit_beacon()) {
-            beacon_frame_type_t current_frame_type = get_frame_type_from_switch();
-            DEBUG_LOG_FLUSH("Starting periodic transmission - Mode: ");
-            DEBUG_LOG_FLUSH(current_frame_type == BEACON_TEST_FRAME ? "TEST\r\n" : "EXERCISE\r\n");
-            start_beacon_frame(current_frame_type);
-        }
-        
-        // Periodic status report
-        static uint32_t last_status = 0;
-        if((current_time - last_status) >= 1000) {
-            last_status = current_time;
-            DEBUG_LOG_FLUSH("Status: phase=");
-            debug_print_uint16(tx_phase);
-            DEBUG_LOG_FLUSH("\r\n");
-        }
-        
-        __delay_ms(10);
+        scheduler_dispatch();   // Taches echues, sinon Idle() jusqu'a la prochaine IT
     }
     
     return 0;
@@ -4,21 +4,23 @@
 #include "system_debug.h"
 #include "protocol_data.h"
 #include "rf_interface.h"
+#include "system_perf.h"
+#include "tx_telemetry.h"
 
 // =============================
 // Variables globales
 // =============================
-uint8_t frame[MESSAGE_BITS];
 volatile uint8_t gps_updated = 0;
-double current_latitude = TEST_LATITUDE;
-double current_longitude = TEST_LONGITUDE;
-double current_altitude = TEST_ALTITUDE;
+int32_t current_latitude = TEST_LATITUDE;      // 1/10000 minute, + = North
+int32_t current_longitude = TEST_LONGITUDE;    // 1/10000 minute, + = East
+int32_t current_altitude = TEST_ALTITUDE;      // Decimeters
 uint8_t beacon_mode = BEACON_MODE_EXERCISE;
 
 // =============================
 // BCH Functions - CS-T001 Annex B Compliant
 // =============================
 
+// Bit-serial reference implementation (kept for table cross-check)
 uint32_t compute_bch(uint64_t data, int num_bits, uint32_t poly, int poly_degree, uint32_t poly_mask) {
     uint32_t reg = 0;
     // Applique le polyn�me complet avec MSB (Annexe T.001 �B.2)
@@ -38,198 +40,393 @@ uint32_t compute_bch(uint64_t data, int num_bits, uint32_t poly, int poly_degree
         if (msb) reg ^= poly_val;
     }
     
-    return reg;
+    // Field width: with poly_mask = degree bits, the XOR of the full
+    // polynomial sets x^degree again (BCH2)
+    return reg & ((1UL << poly_degree) - 1);
 }
 
-// BCH-61 (PDF1)
+// Nibble tables: register feedback after clocking 4 bits out of the top
+// of the LFSR. const -> program memory (PSV), generated from compute_bch().
+const uint32_t bch1_nibble_table[16] = {
+    0x000000, 0x06D9E3, 0x0DB3C6, 0x0B6A25, 0x1B678C, 0x1DBE6F, 0x16D44A, 0x100DA9,
+    0x1016FB, 0x16CF18, 0x1DA53D, 0x1B7CDE, 0x0B7177, 0x0DA894, 0x06C2B1, 0x001B52
+};
+
+const uint16_t bch2_nibble_table[16] = {
+    0x000, 0x539, 0xA72, 0xF4B, 0x1DD, 0x4E4, 0xBAF, 0xE96,
+    0x3BA, 0x683, 0x9C8, 0xCF1, 0x267, 0x75E, 0x815, 0xD2C
+};
+
+// Clock one nibble into a 21-bit (BCH1) / 12-bit (BCH2) register
+#define BCH1_CLOCK_NIBBLE(reg, nib) \
+    (((((reg) << 4) | (nib)) & 0x1FFFFFUL) ^ bch1_nibble_table[((reg) >> 17) & 0x0F])
+#define BCH2_CLOCK_NIBBLE(reg, nib) \
+    (((((reg) << 4) | (nib)) & 0x0FFFu) ^ bch2_nibble_table[((reg) >> 8) & 0x0F])
+
+// BCH-61 (PDF1) - table driven, identical to compute_bch(data, 61, ...)
 uint32_t compute_bch1(uint64_t data) {
-    return compute_bch(data, BCH1_DATA_BITS, BCH1_POLY, BCH1_DEGREE, BCH1_POLY_MASK);
+    PERF_BEGIN(perf_t0);
+    // Split once: 32-bit shifts only in the loop (16-bit core)
+    uint32_t hi = (uint32_t)(data >> 32) & 0x1FFFFFFFUL;   // Bits 60..32
+    uint32_t lo = (uint32_t)data;                          // Bits 31..0
+    
+    // Register starts at 0: the first 21 data bits load directly (no feedback)
+    uint32_t reg = (hi >> 8) & 0x1FFFFFUL;                  // Bits 60..40
+    
+    // Remaining 40 data bits: 10 nibbles
+    reg = BCH1_CLOCK_NIBBLE(reg, (hi >> 4) & 0x0F);
+    reg = BCH1_CLOCK_NIBBLE(reg, hi & 0x0F);
+    for (int8_t shift = 28; shift >= 0; shift -= 4) {
+        reg = BCH1_CLOCK_NIBBLE(reg, (lo >> shift) & 0x0F);
+    }
+    
+    // 21 padding bits: 5 nibbles + 1 bit
+    for (uint8_t i = 0; i < 5; i++) {
+        reg = BCH1_CLOCK_NIBBLE(reg, 0);
+    }
+    uint8_t msb = (reg >> (BCH1_DEGREE - 1)) & 1;
+    reg = (reg << 1) & BCH1_POLY_MASK;
+    if (msb) reg ^= BCH1_POLY;
+    
+    PERF_END(PERF_BCH1, perf_t0);
+    return reg;
 }
 
-// BCH-26 (PDF2)
+// BCH-26 (PDF2) - table driven, identical to compute_bch(data, 26, ...)
 uint16_t compute_bch2(uint32_t data) {
-    return (uint16_t)compute_bch((uint64_t)data, BCH2_DATA_BITS, BCH2_POLY, BCH2_DEGREE, BCH2_POLY_MASK);
+    PERF_BEGIN(perf_t0);
+    // First 12 data bits load directly
+    uint16_t reg = (uint16_t)(data >> 14) & 0x0FFF;        // Bits 25..14
+    
+    // Remaining 14 data bits + 2 padding bits: 4 nibbles
+    reg = BCH2_CLOCK_NIBBLE(reg, (data >> 10) & 0x0F);
+    reg = BCH2_CLOCK_NIBBLE(reg, (data >> 6) & 0x0F);
+    reg = BCH2_CLOCK_NIBBLE(reg, (data >> 2) & 0x0F);
+    reg = BCH2_CLOCK_NIBBLE(reg, (data << 2) & 0x0C);
+    
+    // 10 padding bits left: 2 nibbles + 2 bits (bit-serial tail keeps
+    // the exact final register state of compute_bch)
+    reg = BCH2_CLOCK_NIBBLE(reg, 0);
+    reg = BCH2_CLOCK_NIBBLE(reg, 0);
+    for (uint8_t i = 0; i < 2; i++) {
+        uint8_t msb = (reg >> (BCH2_DEGREE - 1)) & 1;
+        reg = (reg << 1) & BCH2_POLY_MASK;
+        if (msb) reg ^= BCH2_POLY & BCH2_POLY_MASK;    // x^12 already shifted out
+    }
+    
+    PERF_END(PERF_BCH2, perf_t0);
+    return reg;
 }
 
 // =============================
 // Standardized Bit Operations
 // =============================
 
-void set_bit_field(uint8_t *frame, uint16_t cs_start_bit, uint8_t length, uint64_t value) {
-    for (uint8_t i = 0; i < length; i++) {
-        frame[CS_BIT(cs_start_bit + i)] = (value >> (length - 1 - i)) & 1;
+// Word-wise field insert: at most ceil(length/16)+1 read-modify-writes
+void set_bit_field(packed_frame_t *frame, uint16_t cs_start_bit, uint8_t length, uint64_t value) {
+    uint16_t pos = CS_BIT(cs_start_bit);
+    
+    while (length) {
+        uint8_t offset = pos & 0x0F;
+        uint8_t chunk = 16 - offset;
+        if (chunk > length) chunk = length;
+        
+        uint8_t shift = 16 - offset - chunk;
+        uint16_t mask = (uint16_t)((0xFFFFu >> (16 - chunk)) << shift);
+        uint16_t bits = (uint16_t)(value >> (length - chunk));
+        
+        frame->w[pos >> 4] = (frame->w[pos >> 4] & ~mask) | ((bits << shift) & mask);
+        pos += chunk;
+        length -= chunk;
     }
 }
 
-uint64_t get_bit_field(const uint8_t *frame, uint16_t cs_start_bit, uint8_t length) {
+// Word-wise field extract shared by both accessors
+static uint64_t extract_bit_field(volatile const uint16_t *w, uint16_t cs_start_bit, uint8_t length) {
     uint64_t value = 0;
-    for (uint8_t i = 0; i < length; i++) {
-        value = (value << 1) | frame[CS_BIT(cs_start_bit + i)];
+    uint16_t pos = CS_BIT(cs_start_bit);
+    
+    while (length) {
+        uint8_t offset = pos & 0x0F;
+        uint8_t chunk = 16 - offset;
+        if (chunk > length) chunk = length;
+        
+        uint16_t bits = (w[pos >> 4] >> (16 - offset - chunk)) & (0xFFFFu >> (16 - chunk));
+        value = (value << chunk) | bits;
+        pos += chunk;
+        length -= chunk;
     }
     return value;
 }
 
-uint64_t get_bit_field_volatile(volatile const uint8_t *frame, uint16_t cs_start_bit, uint8_t length) {
-    uint64_t value = 0;
-    for (uint8_t i = 0; i < length; i++) {
-        value = (value << 1) | frame[CS_BIT(cs_start_bit + i)];
-    }
-    return value;
+uint64_t get_bit_field(const packed_frame_t *frame, uint16_t cs_start_bit, uint8_t length) {
+    return extract_bit_field(frame->w, cs_start_bit, length);
+}
+
+uint64_t get_bit_field_volatile(volatile const packed_frame_t *frame, uint16_t cs_start_bit, uint8_t length) {
+    return extract_bit_field(frame->w, cs_start_bit, length);
 }
 
 // =============================
 // GPS Functions
 // =============================
 
-void set_gps_position(double lat, double lon, double alt) {
+void set_gps_position(int32_t lat, int32_t lon, int32_t alt) {
     current_latitude = lat;
     current_longitude = lon;
     current_altitude = alt;
     gps_updated = 1;
 }
 
-// Fonction personnalisee de conversion chaa®ne -> float optimisee
-static float custom_atof(const char *p) {
-    int integer = 0;
-    float fractional = 0.0f;
-    float divisor = 10.0f;
-    uint8_t decimal = 0;
-    uint8_t negative = 0;
-    
-    if(*p == '-') {
-        negative = 1;
-        p++;
-    }
-    
-    while(*p) {
-        if(*p == '.') {
-            decimal = 1;
-            p++;
-            continue;
-        }
-        
-        if(*p >= '0' && *p <= '9') {
-            if(!decimal) {
-                integer = integer * 10 + (*p - '0');
-            } else {
-                fractional += (*p - '0') / divisor;
-                divisor *= 10.0f;
-            }
-        }
-        p++;
+// =============================
+// Streaming NMEA parser (GGA/RMC)
+// =============================
+// Fed one byte at a time from the rxQueue consumer: the checksum and the
+// fields are accumulated as characters arrive, no line buffer is kept.
+// Coordinates are carried as int32 in 1/10000 minute of arc.
+
+#define NMEA_FRAC_DIGITS   4       // ddmm.mmmm resolution kept
+#define NMEA_FIELD_LAT_GGA 2
+#define NMEA_FIELD_LAT_RMC 3
+#define NMEA_FIELD_ALT_GGA 9
+
+typedef enum {
+    NMEA_WAIT_START = 0,    // Looking for '$'
+    NMEA_BODY,              // Between '$' and '*'
+    NMEA_CHECKSUM_HI,       // First checksum hex digit
+    NMEA_CHECKSUM_LO        // Second checksum hex digit
+} nmea_state_t;
+
+typedef enum {
+    NMEA_SENTENCE_UNKNOWN = 0,
+    NMEA_SENTENCE_GGA,
+    NMEA_SENTENCE_RMC
+} nmea_sentence_t;
+
+typedef struct {
+    nmea_state_t state;
+    nmea_sentence_t sentence;
+    uint8_t checksum;           // Running XOR of the body
+    uint8_t rx_checksum;        // Received checksum
+    uint8_t field;              // Current field (0 = talker/sentence id)
+    uint8_t field_len;          // Characters seen in the current field
+    char id[3];                 // Last three chars of the sentence id
+    
+    // Numeric field accumulator (value = int_part.frac_part)
+    uint32_t int_part;
+    uint16_t frac_part;
+    uint8_t frac_digits;
+    uint8_t in_frac;
+    uint8_t negative;
+    
+    // Sentence result, committed only on a valid checksum
+    int32_t lat_units;
+    int32_t lon_units;
+    int32_t alt_dm;             // Altitude in decimeters
+    uint8_t have_lat;
+    uint8_t have_lon;
+    uint8_t have_alt;
+    uint8_t fix_valid;
+} nmea_parser_t;
+
+static nmea_parser_t nmea;
+
+// Last published fix (altitude kept across RMC sentences)
+static int32_t gps_alt_dm = TEST_ALTITUDE;
+static uint32_t gps_fix_ms;             // timebase_millis() of the last NMEA fix
+static uint8_t gps_fix_valid = 0;
+
+static void nmea_reset(void) {
+    memset(&nmea, 0, sizeof(nmea));
+}
+
+static void nmea_field_clear(void) {
+    nmea.int_part = 0;
+    nmea.frac_part = 0;
+    nmea.frac_digits = 0;
+    nmea.in_frac = 0;
+    nmea.negative = 0;
+    nmea.field_len = 0;
+}
+
+// ddmm.mmmm / dddmm.mmmm -> 1/10000 minute
+static int32_t nmea_coord_units(void) {
+    uint32_t degrees = nmea.int_part / 100;
+    uint32_t minutes = nmea.int_part % 100;
+    uint32_t frac = nmea.frac_part;
+    
+    for (uint8_t d = nmea.frac_digits; d < NMEA_FRAC_DIGITS; d++) frac *= 10;
+    return (int32_t)((degrees * 60 + minutes) * 10000UL + frac);
+}
+
+// Value with one decimal (altitude) -> tenths
+static int32_t nmea_value_tenths(void) {
+    uint32_t tenths = nmea.int_part * 10;
+    if (nmea.frac_digits) {
+        uint16_t f = nmea.frac_part;
+        for (uint8_t d = nmea.frac_digits; d > 1; d--) f /= 10;
+        tenths += f;
     }
-    
-    float result = (float)integer + fractional;
-    return negative ? -result : result;
+    return nmea.negative ? -(int32_t)tenths : (int32_t)tenths;
 }
 
-// Fonction de validation de checksum NMEA
-static uint8_t validate_nmea_checksum(const char *msg) {
-    const char *p = msg + 1; // Apres '$'
-    uint8_t checksum = 0;
-    char hex[3] = {0};
-    
-    while(*p && *p != '*') {
-        checksum ^= *p++;
+static void nmea_field_char(char c) {
+    if (nmea.field == 0) {
+        // Sentence id (GPGGA, GNRMC ...): keep the last three chars
+        nmea.id[0] = nmea.id[1];
+        nmea.id[1] = nmea.id[2];
+        nmea.id[2] = c;
+        return;
     }
-    
-    if(*p == '*') {
-        hex[0] = *(p+1);
-        hex[1] = *(p+2);
-        return checksum == (uint8_t)strtol(hex, NULL, 16);
+    if (c >= '0' && c <= '9') {
+        if (!nmea.in_frac) {
+            if (nmea.int_part < 100000000UL) nmea.int_part = nmea.int_part * 10 + (c - '0');
+        } else if (nmea.frac_digits < NMEA_FRAC_DIGITS) {
+            nmea.frac_part = nmea.frac_part * 10 + (c - '0');
+            nmea.frac_digits++;
+        }
+    } else if (c == '.') {
+        nmea.in_frac = 1;
+    } else if (c == '-') {
+        nmea.negative = 1;
+    }
+    nmea.field_len++;
+    
+    // Single-character fields handled on the fly
+    if (nmea.field_len == 1) {
+        uint8_t lat_hemi = (nmea.sentence == NMEA_SENTENCE_GGA) ? 3 : 4;
+        if (nmea.field == lat_hemi && c == 'S') nmea.lat_units = -nmea.lat_units;
+        if (nmea.field == lat_hemi + 2 && c == 'W') nmea.lon_units = -nmea.lon_units;
+        if (nmea.sentence == NMEA_SENTENCE_GGA && nmea.field == 6) nmea.fix_valid = (c != '0');
+        if (nmea.sentence == NMEA_SENTENCE_RMC && nmea.field == 2) nmea.fix_valid = (c == 'A');
     }
-    return 0;
 }
 
-void parse_nmea_gga(const char *line) {
-    if(strlen(line) < 20) {
-        DEBUG_LOG_FLUSH("NMEA: Trame trop courte\r\n");
-        return;
+// Field separator: store the numeric fields of interest
+static void nmea_field_end(void) {
+    if (nmea.field == 0) {
+        if (nmea.id[0] == 'G' && nmea.id[1] == 'G' && nmea.id[2] == 'A') nmea.sentence = NMEA_SENTENCE_GGA;
+        else if (nmea.id[0] == 'R' && nmea.id[1] == 'M' && nmea.id[2] == 'C') nmea.sentence = NMEA_SENTENCE_RMC;
+        else nmea.sentence = NMEA_SENTENCE_UNKNOWN;
+    } else if (nmea.field_len) {
+        uint8_t lat_field = (nmea.sentence == NMEA_SENTENCE_GGA) ? NMEA_FIELD_LAT_GGA : NMEA_FIELD_LAT_RMC;
+        if (nmea.field == lat_field) {
+            nmea.lat_units = nmea_coord_units();
+            nmea.have_lat = 1;
+        } else if (nmea.field == lat_field + 2) {
+            nmea.lon_units = nmea_coord_units();
+            nmea.have_lon = 1;
+        } else if (nmea.sentence == NMEA_SENTENCE_GGA && nmea.field == NMEA_FIELD_ALT_GGA) {
+            nmea.alt_dm = nmea_value_tenths();
+            nmea.have_alt = 1;
+        }
     }
+    nmea.field++;
+    nmea_field_clear();
+}
+
+static uint8_t nmea_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0xFF;
+}
+
+// Validated sentence: publish one position snapshot
+static void nmea_commit(void) {
+    if (nmea.sentence == NMEA_SENTENCE_UNKNOWN) return;
+    if (!nmea.fix_valid || !nmea.have_lat || !nmea.have_lon) return;
     
-    // Verification rapide du format
-    if(line[0] != '$') return;
-    if(strncmp(line, "$GPGGA", 6) && strncmp(line, "$GNGGA", 6)) return;
-    
-    // Validation checksum
-    if(!validate_nmea_checksum(line)) {
-        DEBUG_LOG_FLUSH("NMEA: Bad checksum\r\n");
+    if (labs(nmea.lat_units) > 90L * GPS_UNITS_PER_DEGREE ||
+        labs(nmea.lon_units) > 180L * GPS_UNITS_PER_DEGREE) {
+        DEBUG_LOG_FLUSH("NMEA: Invalid coords\r\n");
         return;
     }
-    
-    // Variables locales pour eviter les acces memoire repetes
-    char field[15][16] = {0};
-    uint8_t field_count = 0;
-    const char *ptr = line;
-    char *field_ptr = field[0];
-    
-    // Parsing optimise sans utiliser strtok
-    while(*ptr && field_count < 15) {
-        if(*ptr == ',' || *ptr == '*') {
-            *field_ptr = '\0';
-            field_count++;
-            field_ptr = field[field_count];
-            ptr++;
-            continue;
-        }
-        
-        if(*ptr == '$') {
-            ptr++;
-            continue;
-        }
-        
-        if(field_ptr < &field[field_count][15]) {
-            *field_ptr++ = *ptr;
+    if (nmea.have_alt) gps_alt_dm = nmea.alt_dm;
+    
+    set_gps_position(nmea.lat_units, nmea.lon_units, gps_alt_dm);
+    gps_fix_ms = timebase_millis();
+    gps_fix_valid = 1;
+    
+    if (debug_flags.log_mode == LOG_MODE_ALL) {
+        DEBUG_LOG_FLUSH("GPS: lat=");
+        debug_print_int32(nmea.lat_units);
+        DEBUG_LOG_FLUSH(" lon=");
+        debug_print_int32(nmea.lon_units);
+        DEBUG_LOG_FLUSH(" (1e-4 min) alt=");
+        debug_print_int32(gps_alt_dm);
+        DEBUG_LOG_FLUSH("dm\r\n");
+    }
+}
+
+void nmea_parser_feed(char c) {
+    switch (nmea.state) {
+        case NMEA_WAIT_START:
+            if (c == '$') {
+                nmea_reset();
+                nmea.state = NMEA_BODY;
+            }
+            break;
+            
+        case NMEA_BODY:
+            if (c == '*') {
+                nmea_field_end();
+                nmea.state = NMEA_CHECKSUM_HI;
+            } else if (c == '$' || c == '\r' || c == '\n') {
+                nmea_reset();                   // Truncated sentence
+                nmea.state = (c == '$') ? NMEA_BODY : NMEA_WAIT_START;
+            } else {
+                nmea.checksum ^= (uint8_t)c;
+                if (c == ',') nmea_field_end();
+                else nmea_field_char(c);
+            }
+            break;
+            
+        case NMEA_CHECKSUM_HI:
+        case NMEA_CHECKSUM_LO: {
+            uint8_t v = nmea_hex_value(c);
+            if (v == 0xFF) {
+                nmea.state = NMEA_WAIT_START;
+                break;
+            }
+            nmea.rx_checksum = (nmea.rx_checksum << 4) | v;
+            if (nmea.state == NMEA_CHECKSUM_HI) {
+                nmea.state = NMEA_CHECKSUM_LO;
+            } else {
+                if (nmea.rx_checksum == nmea.checksum) nmea_commit();
+                else DEBUG_LOG_FLUSH("NMEA: Bad checksum\r\n");
+                nmea.state = NMEA_WAIT_START;
+            }
+            break;
         }
-        ptr++;
     }
-    
-    // Verification des champs critiques
-    if(!field[6][0] || !field[2][0] || !field[3][0] || 
-       !field[4][0] || !field[5][0] || !field[9][0]) {
-        DEBUG_LOG_FLUSH("NMEA: Missing fields\r\n");
-        return;
+}
+
+// rxQueue consumer (main loop): U1RX ISR writes rxTail, we advance rxHead
+void gps_uart_task(void) {
+    if (rxOverflowed) {
+        rxOverflowed = 0;
+        nmea_reset();           // Bytes lost: drop the sentence in progress
     }
-    
-    // Conversion qualite de fix
-    uint8_t fix_quality = atoi(field[6]);
-    if(fix_quality == 0) {
-        DEBUG_LOG_FLUSH("NMEA: No fix\r\n");
-        return;
+    while (rxHead != rxTail) {
+        char c = rxQueue[rxHead];
+        rxHead = (rxHead + 1) % UART_BUFFER_SIZE;
+        nmea_parser_feed(c);
     }
-    
-    // Conversion latitude
-    float lat_val = custom_atof(field[2]);
-    float latitude = (int)(lat_val / 100) + fmod(lat_val, 100.0f) / 60.0f;
-    if(field[3][0] == 'S') latitude = -latitude;
-    
-    // Conversion longitude
-    float lon_val = custom_atof(field[4]);
-    float longitude = (int)(lon_val / 100) + fmod(lon_val, 100.0f) / 60.0f;
-    if(field[5][0] == 'W') longitude = -longitude;
-    
-    // Validation des coordonnees
-    if(fabs(latitude) > 90.0f || fabs(longitude) > 180.0f) {
-        DEBUG_LOG_FLUSH("NMEA: Invalid coords\r\n");
-        return;
+}
+
+uint16_t gps_fix_age_s(void) {
+    if (!gps_fix_valid) return 0xFFFF;
+    uint32_t age = (timebase_millis() - gps_fix_ms) / 1000UL;
+    return (age > 0xFFFE) ? 0xFFFE : (uint16_t)age;
+}
+
+// Whole-line entry point kept for callers holding a complete sentence
+void parse_nmea_gga(const char *line) {
+    nmea_reset();
+    while (*line) {
+        nmea_parser_feed(*line++);
     }
-    
-    // Conversion altitude
-    float altitude = custom_atof(field[9]);
-    
-    // Mise a  jour position
-    set_gps_position(latitude, longitude, altitude);
-    
-    // Debug optimise
-    DEBUG_LOG_FLUSH("GPS: ");
-    debug_print_float(latitude, 6);
-    debug_print_char(field[3][0]);
-    DEBUG_LOG_FLUSH(",");
-    debug_print_float(longitude, 6);
-    debug_print_char(field[5][0]);
-    DEBUG_LOG_FLUSH(",Alt:");
-    debug_print_float(altitude, 1);
-    DEBUG_LOG_FLUSH("m\r\n");
 }
 
 // =============================
@@ -242,10 +439,26 @@ void debug_print_int16(int16_t value) {
     DEBUG_LOG_FLUSH(buffer);
 }
 
-uint32_t compute_30min_position(double lat, double lon) {
-    // Conversion en pas de 0.5� avec arrondi
-    int16_t lat_steps = (int32_t)round(lat * 2.0);
-    int16_t lon_steps = (int32_t)round(lon * 2.0);
+// Affichage d'une coordonnee 1/10000 minute en degres (6 decimales, sans float)
+static void debug_print_gps_units(int32_t units) {
+    uint32_t a = (uint32_t)labs(units);
+    uint32_t micro = (a % GPS_UNITS_PER_DEGREE) * 5 / 3;   // 1e-6 deg
+    char buffer[16];
+    
+    snprintf(buffer, sizeof(buffer), "%s%lu.%06lu", (units < 0) ? "-" : "",
+             (unsigned long)(a / GPS_UNITS_PER_DEGREE), (unsigned long)micro);
+    debug_print_str(buffer);
+}
+
+// a / d arrondi au plus proche (demi vers l'exterieur), a >= 0
+#define GPS_ROUND_DIV(a, d)  (((a) + (d) / 2) / (d))
+
+uint32_t compute_30min_position(int32_t lat, int32_t lon) {
+    // Conversion en pas de 0.5 deg avec arrondi (0.5 deg = 300000 unites)
+    uint32_t lat_abs = GPS_ROUND_DIV((uint32_t)labs(lat), GPS_UNITS_PER_DEGREE / 2);
+    uint32_t lon_abs = GPS_ROUND_DIV((uint32_t)labs(lon), GPS_UNITS_PER_DEGREE / 2);
+    int16_t lat_steps = (lat < 0) ? -(int16_t)lat_abs : (int16_t)lat_abs;
+    int16_t lon_steps = (lon < 0) ? -(int16_t)lon_abs : (int16_t)lon_abs;
     
     // Clamping des valeurs
     lat_steps = (lat_steps < -128) ? -128 : (lat_steps > 127) ? 127 : lat_steps;
@@ -283,20 +496,21 @@ uint32_t compute_30min_position(double lat, double lon) {
     return position;
 }
 
-cs_gps_position_t encode_gps_position_complete(double lat, double lon) {
+cs_gps_position_t encode_gps_position_complete(int32_t lat, int32_t lon) {
     cs_gps_position_t result = {0};
     
-    if(__builtin_fabs(lat) > 90.0 || __builtin_fabs(lon) > 180.0) {
+    if(labs(lat) > 90L * GPS_UNITS_PER_DEGREE || labs(lon) > 180L * GPS_UNITS_PER_DEGREE) {
         return result;
     }
 
-    uint32_t lat_units = (uint32_t)__builtin_round(__builtin_fabs(lat) * 900.0);
-    uint32_t lon_units = (uint32_t)__builtin_round(__builtin_fabs(lon) * 900.0);
+    // Pas de 1/900 deg = 2000/3 unites : round(|u| * 3 / 2000)
+    uint32_t lat_units = GPS_ROUND_DIV((uint32_t)labs(lat) * 3UL, 2000UL);
+    uint32_t lon_units = GPS_ROUND_DIV((uint32_t)labs(lon) * 3UL, 2000UL);
     lat_units &= 0x7FFFF;
     lon_units &= 0x7FFFF;
 
-    uint64_t lat_encoded = ((uint64_t)lat_units << 1) | (lat < 0.0 ? 1ULL : 0ULL);
-    uint64_t lon_encoded = ((uint64_t)lon_units << 1) | (lon < 0.0 ? 1ULL : 0ULL);
+    uint64_t lat_encoded = ((uint64_t)lat_units << 1) | (lat < 0 ? 1ULL : 0ULL);
+    uint64_t lon_encoded = ((uint64_t)lon_units << 1) | (lon < 0 ? 1ULL : 0ULL);
     result.full_position_40bit = (lat_encoded << 20) | lon_encoded;
     result.coarse_position_21bit = (uint32_t)(result.full_position_40bit >> 19);
     result.fine_position_19bit = compute_30min_position(lat, lon);
@@ -313,7 +527,7 @@ cs_gps_position_t encode_gps_position_complete(double lat, double lon) {
     return result;
 }
 
-uint32_t compute_4sec_offset(double lat, double lon, uint32_t position_30min) {
+uint32_t compute_4sec_offset(int32_t lat, int32_t lon, uint32_t position_30min) {
     // Extraction position de reference PDF-1 (19 bits)
     uint16_t lat_ref_raw = (position_30min >> 10) & 0x1FF;  // 9 bits latitude
     uint16_t lon_ref_raw = position_30min & 0x3FF;          // 10 bits longitude
@@ -330,37 +544,27 @@ uint32_t compute_4sec_offset(double lat, double lon, uint32_t position_30min) {
         lon_ref_signed |= 0xFC00;  // etendre signe sur 16 bits
     }
     
-    // Position de reference en degres (resolution 0.5�)
-    double lat_ref_deg = lat_ref_signed * 0.5;
-    double lon_ref_deg = lon_ref_signed * 0.5;
-    
-    // Calcul des offsets en degres
-    double lat_offset_deg = lat - lat_ref_deg;
-    double lon_offset_deg = lon - lon_ref_deg;
-    
-    // Conversion en minutes
-    double lat_offset_min = fabs(lat_offset_deg) * 60.0;
-    double lon_offset_min = fabs(lon_offset_deg) * 60.0;
+    // Offsets en 1/10000 minute par rapport a la reference (pas de 0.5 deg)
+    int32_t lat_offset = lat - (int32_t)lat_ref_signed * (GPS_UNITS_PER_DEGREE / 2);
+    int32_t lon_offset = lon - (int32_t)lon_ref_signed * (GPS_UNITS_PER_DEGREE / 2);
+    uint32_t lat_abs = (uint32_t)labs(lat_offset);
+    uint32_t lon_abs = (uint32_t)labs(lon_offset);
     
     // Bits de signe (1 = positif, 0 = negatif)
-    uint8_t lat_sign = (lat_offset_deg >= 0) ? 1 : 0;
-    uint8_t lon_sign = (lon_offset_deg >= 0) ? 1 : 0;
-    
-    // Separation minutes entia¨res et secondes
-    uint8_t lat_min_int = (uint8_t)lat_offset_min;
-    uint8_t lon_min_int = (uint8_t)lon_offset_min;
+    uint8_t lat_sign = (lat_offset >= 0) ? 1 : 0;
+    uint8_t lon_sign = (lon_offset >= 0) ? 1 : 0;
     
-    // Calcul des secondes (partie fractionnaire * 60)
-    double lat_sec = (lat_offset_min - lat_min_int) * 60.0;
-    double lon_sec = (lon_offset_min - lon_min_int) * 60.0;
+    // Minutes entieres (saturation a 15 sur 4 bits)
+    uint32_t lat_min = lat_abs / 10000;
+    uint32_t lon_min = lon_abs / 10000;
+    uint8_t lat_min_int = (lat_min > 15) ? 15 : (uint8_t)lat_min;
+    uint8_t lon_min_int = (lon_min > 15) ? 15 : (uint8_t)lon_min;
     
-    // Conversion en increments de 4 secondes avec arrondi
-    uint8_t lat_sec_4 = (uint8_t)((lat_sec + 2.0) / 4.0);
-    uint8_t lon_sec_4 = (uint8_t)((lon_sec + 2.0) / 4.0);
+    // Increments de 4 secondes avec arrondi : (frac * 60 / 10000 + 2) / 4
+    uint8_t lat_sec_4 = (lat_min > 15) ? 15 : (uint8_t)(((lat_abs % 10000) * 3 + 1000) / 2000);
+    uint8_t lon_sec_4 = (lon_min > 15) ? 15 : (uint8_t)(((lon_abs % 10000) * 3 + 1000) / 2000);
     
     // Saturation a  15 (4 bits max)
-    if (lat_min_int > 15) lat_min_int = 15;
-    if (lon_min_int > 15) lon_min_int = 15;
     if (lat_sec_4 > 15) lat_sec_4 = 15;
     if (lon_sec_4 > 15) lon_sec_4 = 15;
     
@@ -383,22 +587,24 @@ uint32_t compute_4sec_offset(double lat, double lon, uint32_t position_30min) {
 }
 
 // Conversion altitude -> code 4 bits (Â§A3.3.2.4)
-uint8_t altitude_to_code(double altitude) {
-    if (altitude < 400)   return 0x0;
-    if (altitude < 800)   return 0x1;
-    if (altitude < 1200)  return 0x2;
-    if (altitude < 1600)  return 0x3;
-    if (altitude < 2200)  return 0x4;
-    if (altitude < 2800)  return 0x5;
-    if (altitude < 3400)  return 0x6;
-    if (altitude < 4000)  return 0x7;
-    if (altitude < 4800)  return 0x8;
-    if (altitude < 5600)  return 0x9;
-    if (altitude < 6600)  return 0xA;
-    if (altitude < 7600)  return 0xB;
-    if (altitude < 8800)  return 0xC;
-    if (altitude < 10000) return 0xD;
-    if (altitude > 10000) return 0xE;
+// Seuils en metres, altitude en decimetres
+uint8_t altitude_to_code(int32_t altitude_dm) {
+    int32_t altitude = altitude_dm;
+    if (altitude < 4000)   return 0x0;
+    if (altitude < 8000)   return 0x1;
+    if (altitude < 12000)  return 0x2;
+    if (altitude < 16000)  return 0x3;
+    if (altitude < 22000)  return 0x4;
+    if (altitude < 28000)  return 0x5;
+    if (altitude < 34000)  return 0x6;
+    if (altitude < 40000)  return 0x7;
+    if (altitude < 48000)  return 0x8;
+    if (altitude < 56000)  return 0x9;
+    if (altitude < 66000)  return 0xA;
+    if (altitude < 76000)  return 0xB;
+    if (altitude < 88000)  return 0xC;
+    if (altitude < 100000) return 0xD;
+    if (altitude > 100000) return 0xE;
     return 0xF; // default if altitude information is not available
 }
 
@@ -406,25 +612,17 @@ uint8_t altitude_to_code(double altitude) {
 // Frame Construction with Compliant Bit Indexing
 // =============================
 
-void build_compliant_frame(void) {
-    // Local frame buffer - dsPIC33CK stack optimization
-    uint8_t frame[MESSAGE_BITS];
+// Static PDF-1 header: written once per cache (or on beacon_mode change)
+static void frame_cache_write_header(frame_cache_t *cache, uint8_t mode) {
+    packed_frame_t *frame = &cache->frame;
     
-    // Fast zero initialization
-    memset(frame, 0, MESSAGE_BITS);
-    
-    // Message de construction unique
-    if (!debug_flags.build_msg_printed) {
-        debug_flags.build_msg_printed = 1;
-        DEBUG_LOG_FLUSH("Building CS-T001 compliant frame...\r\n");
-         
-    }
+    memset(frame, 0, sizeof(*frame));
     
     // CS-T001 frame construction - bit-exact
     set_bit_field(frame, FRAME_PREAMBLE_START, FRAME_PREAMBLE_LENGTH, 0x7FFFUL);
     
     // Sync pattern selection
-    uint16_t sync_pattern = (beacon_mode == BEACON_MODE_TEST) ? SYNC_SELF_TEST : SYNC_NORMAL_LONG;
+    uint16_t sync_pattern = (mode == BEACON_MODE_TEST) ? SYNC_SELF_TEST : SYNC_NORMAL_LONG;
     set_bit_field(frame, FRAME_SYNC_START, FRAME_SYNC_LENGTH, sync_pattern);
     
     // Format and protocol flags
@@ -432,136 +630,124 @@ void build_compliant_frame(void) {
     set_bit_field(frame, FRAME_PROTOCOL_FLAG_BIT, 1, 0UL);
     
     // Country and protocol codes
-    set_bit_field(frame, FRAME_COUNTRY_START, FRAME_COUNTRY_LENGTH, COUNTRY_CODE_FRANCE);
+    set_bit_field(frame, FRAME_COUNTRY_START, FRAME_COUNTRY_LENGTH, cache->country);
     set_bit_field(frame, FRAME_PROTOCOL_START, FRAME_PROTOCOL_LENGTH, PROTOCOL_ELT_DT);
     
-    // Beacon ID (example - replace with actual ID)
-    set_bit_field(frame, FRAME_BEACON_ID_START, FRAME_BEACON_ID_LENGTH, 0x123456UL);
+    // Beacon ID (per cache: one per beacon profile)
+    set_bit_field(frame, FRAME_BEACON_ID_START, FRAME_BEACON_ID_LENGTH, cache->beacon_id);
+    
+    cache->mode = mode;
+    cache->header_valid = 1;
+}
+
+void frame_cache_init(frame_cache_t *cache, uint32_t beacon_id, uint16_t country) {
+    cache->beacon_id = beacon_id & 0x3FFFFFFUL;
+    cache->country = country & 0x3FF;
+    cache->header_valid = 0;
+}
+
+void frame_cache_invalidate(frame_cache_t *cache) {
+    cache->header_valid = 0;
+}
+
+// Re-encode only what changed since the last call:
+// position (bits 67-85) -> BCH1, PDF-2 (bits 107-132) -> BCH2
+uint8_t frame_cache_update(frame_cache_t *cache, uint8_t mode,
+                           int32_t lat, int32_t lon, int32_t alt) {
+    uint8_t changed = 0;
+    PERF_BEGIN(perf_t0);
+    
+    if (!cache->header_valid || cache->mode != mode) {
+        frame_cache_write_header(cache, mode);
+        changed = FRAME_CACHE_HEADER | FRAME_CACHE_PDF1 | FRAME_CACHE_PDF2;
+    }
+    if (!changed && lat == cache->latitude && lon == cache->longitude && alt == cache->altitude) {
+        PERF_END(PERF_FRAME_ENCODE, perf_t0);
+        return 0;   // Same inputs as the frame already encoded
+    }
+    cache->latitude = lat;
+    cache->longitude = lon;
+    cache->altitude = alt;
+    
+    packed_frame_t *frame = &cache->frame;
+    cs_gps_position_t gps_pos = encode_gps_position_complete(lat, lon);
+    
+    // PDF-2 data: activation(2) | altitude(4) | freshness(2) | offset(18)
+    uint32_t pdf2 = ((uint32_t)0x0 << 24) |
+                    ((uint32_t)altitude_to_code(alt) << 20) |
+                    ((uint32_t)0x2 << 18) |
+                    (gps_pos.offset_position_18bit & 0x3FFFFUL);
+    
+    if ((changed & FRAME_CACHE_PDF1) || gps_pos.fine_position_19bit != cache->position_19bit) {
+        set_bit_field(frame, FRAME_POSITION_START, FRAME_POSITION_LENGTH, gps_pos.fine_position_19bit);
+        cache->position_19bit = gps_pos.fine_position_19bit;
+        
+        // BCH1 calculation - CS-T001 compliant
+        uint64_t pdf1_data = get_bit_field(frame, 25, 61);
+        set_bit_field(frame, FRAME_BCH1_START, FRAME_BCH1_LENGTH, compute_bch1(pdf1_data));
+        changed |= FRAME_CACHE_PDF1;
+    }
+    
+    if ((changed & FRAME_CACHE_PDF2) || pdf2 != cache->pdf2_26bit) {
+        set_bit_field(frame, FRAME_ACTIVATION_START, 26, pdf2);
+        cache->pdf2_26bit = pdf2;
+        
+        // BCH2 calculation - CS-T001 compliant
+        set_bit_field(frame, FRAME_BCH2_START, FRAME_BCH2_LENGTH, compute_bch2(pdf2));
+        changed |= FRAME_CACHE_PDF2;
+    }
     
-    // GPS position encoding
-    cs_gps_position_t gps_pos = encode_gps_position_complete(current_latitude, current_longitude);
-    set_bit_field(frame, FRAME_POSITION_START, FRAME_POSITION_LENGTH, gps_pos.fine_position_19bit);
     // DEBUG CRITIQUE
-    if(!debug_flags.gps_encoding_printed) {
+    if((changed & FRAME_CACHE_PDF1) && !debug_flags.gps_encoding_printed) {
         DEBUG_LOG_FLUSH("GPS FINE POS: 0x");
-         
         debug_print_hex24(gps_pos.fine_position_19bit);
         DEBUG_LOG_FLUSH("\r\n");
         debug_flags.gps_encoding_printed = 1;
     }
     
-    // BCH1 calculation - CS-T001 compliant
-    uint64_t pdf1_data = get_bit_field(frame, 25, 61);
-    uint32_t bch1 = compute_bch1(pdf1_data);
-    set_bit_field(frame, FRAME_BCH1_START, FRAME_BCH1_LENGTH, bch1);
-       
-    // PDF-2 additional data
-    set_bit_field(frame, FRAME_ACTIVATION_START, FRAME_ACTIVATION_LENGTH, 0x0UL);
-    
-    uint8_t alt_code = altitude_to_code(current_altitude);
-    set_bit_field(frame, FRAME_ALTITUDE_START, FRAME_ALTITUDE_LENGTH, alt_code);
-    
-    set_bit_field(frame, FRAME_FRESHNESS_START, FRAME_FRESHNESS_LENGTH, 0x2UL);
-    set_bit_field(frame, FRAME_OFFSET_START, FRAME_OFFSET_LENGTH, gps_pos.offset_position_18bit);
-    
-    // BCH2 calculation - CS-T001 compliant
-    uint32_t pdf2_data = get_bit_field(frame, 107, 26);
-    uint16_t bch2 = compute_bch2(pdf2_data);
-    set_bit_field(frame, FRAME_BCH2_START, FRAME_BCH2_LENGTH, bch2);
-       
-    // Critical validation - dsPIC33CK optimized
-    uint64_t pdf1_check = get_bit_field(frame, 25, 61);
-    uint32_t bch1_check = (uint32_t)get_bit_field(frame, 86, 21);
-    uint32_t bch1_calc = compute_bch1(pdf1_check);
+    PERF_END(PERF_FRAME_ENCODE, perf_t0);
+    return changed;
+}
 
-    uint32_t pdf2_check = (uint32_t)get_bit_field(frame, 107, 26);
-    uint16_t bch2_check = (uint16_t)get_bit_field(frame, 133, 12);
-    uint16_t bch2_calc = compute_bch2(pdf2_check);
+uint8_t frame_check_bch(const packed_frame_t *frame) {
+    uint32_t bch1 = compute_bch1(get_bit_field(frame, 25, 61));
+    uint16_t bch2 = compute_bch2((uint32_t)get_bit_field(frame, 107, 26));
+    return bch1 == (uint32_t)get_bit_field(frame, FRAME_BCH1_START, FRAME_BCH1_LENGTH) &&
+           bch2 == (uint16_t)get_bit_field(frame, FRAME_BCH2_START, FRAME_BCH2_LENGTH);
+}
 
-    // Single validation message
-    if (!debug_flags.validation_printed) {
+// Frame cache of the main beacon
+static frame_cache_t beacon_cache = { .beacon_id = BEACON_DEFAULT_ID, .country = COUNTRY_CODE_FRANCE };
+
+void build_compliant_frame(void) {
+    PERF_BEGIN(perf_t0);
+    
+    // Message de construction unique
+    if (!debug_flags.build_msg_printed) {
+        debug_flags.build_msg_printed = 1;
+        DEBUG_LOG_FLUSH("Building CS-T001 compliant frame...\r\n");
+    }
+    
+    uint8_t changed = frame_cache_update(&beacon_cache, beacon_mode,
+                                         current_latitude, current_longitude, current_altitude);
+    
+    // Critical validation, only when a BCH was recomputed
+    if (changed && !debug_flags.validation_printed) {
         debug_flags.validation_printed = 1;
-        if (bch1_calc != bch1_check || bch2_calc != bch2_check) {
+        if (!frame_check_bch(&beacon_cache.frame)) {
             DEBUG_LOG_FLUSH("BCH Validation FAILED!\r\n");
-             
         }
     }
 
-    // Fast copy to global buffer - dsPIC33CK optimized
-    memcpy((void*)beacon_frame, frame, MESSAGE_BITS);
+    // Copy the cached frame into the back buffer (slots alternate)
+    memcpy((void*)&beacon_frame, &beacon_cache.frame, sizeof(packed_frame_t));
+
+    PERF_END(PERF_FRAME_BUILD, perf_t0);
 
     // Single comprehensive log
     debug_print_complete_frame_info(1);
 }
 
-void build_test_frame(void) {
-    // Set test coordinates
-    set_gps_position(TEST_LATITUDE, TEST_LONGITUDE, TEST_ALTITUDE);
-    beacon_mode = BEACON_MODE_TEST;
-    
-    // Build compliant frame
-    build_compliant_frame();
-    
-    // Single test message
-    if (!debug_flags.test_frame_msg_printed) {
-        debug_flags.test_frame_msg_printed = 1;
-        DEBUG_LOG_FLUSH("Test frame built with fixed GPS values\r\n");
-         
-    }
-	rf_set_power_level(RF_POWER_LOW);  // Puissance reduite
-}
-
-// Backward compatibility - Exercise frame
-void build_exercise_frame(void) {
-    beacon_mode = BEACON_MODE_EXERCISE;
-    
-    // Build compliant frame with current GPS position
-    build_compliant_frame();
-    
-    rf_set_power_level(RF_POWER_HIGH);
-}
-
-void start_beacon_frame(beacon_frame_type_t frame_type) {
-    switch(frame_type) {
-        case BEACON_TEST_FRAME:
-            build_test_frame();       // TEST mode with fixed coordinates and low power
-            set_tx_interval(5000);    // DEBUG: Disabled for scope (50ms forced)
-            break;
-            
-        case BEACON_EXERCISE_FRAME:
-            build_exercise_frame();   // EXERCISE mode with high power
-            set_tx_interval(50000);   // DEBUG: Disabled for scope (50ms forced)
-            break;
-    }
-    
-    // Validation protocolaire
-    cs_t001_full_compliance_check();
-    
-    // Transmission physique
-    transmit_beacon_frame();
-}
-
-void transmit_beacon_frame(void) {
-	    if (!validate_frame_hardware()) {
-        DEBUG_LOG_FLUSH("ERROR: Invalid frame - transmission aborted\r\n");
-        return;
-    }
-	
-    // 1. Copie atomique vers le buffer RF
-    __builtin_disable_interrupts();
-    start_transmission(beacon_frame); // D�fini dans system_comms.c
-    __builtin_enable_interrupts();
-    
-    // 2. Log de confirmation
-    if (!debug_flags.transmission_printed) {
-        debug_flags.transmission_printed = 1;
-        DEBUG_LOG_FLUSH("Transmission started: ");
-        DEBUG_LOG_FLUSH((beacon_mode == BEACON_MODE_TEST) ? 
-                        "TEST" : "EXERCISE");
-        DEBUG_LOG_FLUSH(" mode\r\n");
-    }
-}
-
 // =============================
 // Comprehensive CS-T001 Test Vectors
 // =============================
@@ -657,15 +843,15 @@ void validate_position_encoding(void) {
     
     // Test known coordinates
     struct {
-        double lat, lon;
+        int32_t lat, lon;        // 1/10000 minute
         const char *location;
     } test_coords[] = {
         {TEST_LATITUDE, TEST_LONGITUDE, "Test Location"},
-        {0.0, 0.0, "Equator/Prime Meridian"},
-        {90.0, 180.0, "North Pole/Date Line"},
-        {-90.0, -180.0, "South Pole/Date Line"},
-        {45.5, -73.6, "Montreal, Canada"},
-        {48.8566, 2.3522, "Paris, France"}
+        {0, 0, "Equator/Prime Meridian"},
+        {54000000L, 108000000L, "North Pole/Date Line"},      // 90.0, 180.0
+        {-54000000L, -108000000L, "South Pole/Date Line"},    // -90.0, -180.0
+        {27300000L, -44160000L, "Montreal, Canada"},          // 45.5, -73.6
+        {29313960L, 1411320L, "Paris, France"}                // 48.8566, 2.3522
     };
      
     for (size_t i = 0; i < sizeof(test_coords)/sizeof(test_coords[0]); i++) {
@@ -673,9 +859,9 @@ void validate_position_encoding(void) {
         
         DEBUG_LOG_FLUSH(test_coords[i].location);
         DEBUG_LOG_FLUSH(": (");
-        debug_print_float(test_coords[i].lat, 6);
+        debug_print_gps_units(test_coords[i].lat);
         DEBUG_LOG_FLUSH(", ");
-        debug_print_float(test_coords[i].lon, 6);
+        debug_print_gps_units(test_coords[i].lon);
         DEBUG_LOG_FLUSH(")\r\n");
         
         DEBUG_LOG_FLUSH("  40-bit: 0x");
@@ -717,6 +903,37 @@ void test_bch_norm(void) {
     }
 }
 
+// Table-driven encoders must match the bit-serial reference on every vector
+void test_bch_table_equivalence(void) {
+    uint8_t mismatches = 0;
+    
+    for (size_t i = 0; i < sizeof(cs_test_vectors)/sizeof(cs_test_vectors[0]); i++) {
+        const cs_test_vector_t *tv = &cs_test_vectors[i];
+        uint32_t table, serial;
+        
+        if (tv->data_bits == BCH1_DATA_BITS) {
+            table = compute_bch1(tv->input_data);
+            serial = compute_bch(tv->input_data, BCH1_DATA_BITS, BCH1_POLY, BCH1_DEGREE, BCH1_POLY_MASK);
+        } else {
+            table = compute_bch2((uint32_t)tv->input_data);
+            serial = compute_bch(tv->input_data, BCH2_DATA_BITS, BCH2_POLY, BCH2_DEGREE, BCH2_POLY_MASK);
+        }
+        
+        if (table != serial) {
+            DEBUG_LOG_FLUSH("BCH table MISMATCH ");
+            DEBUG_LOG_FLUSH(tv->name);
+            DEBUG_LOG_FLUSH(": 0x");
+            debug_print_hex24(table);
+            DEBUG_LOG_FLUSH(" vs 0x");
+            debug_print_hex24(serial);
+            DEBUG_LOG_FLUSH("\r\n");
+            mismatches++;
+        }
+    }
+    
+    DEBUG_LOG_FLUSH(mismatches ? "BCH table/serial: FAIL\r\n" : "BCH table/serial: MATCH\r\n");
+}
+
 void test_cs_t001_vectors(void) {
     // Test avec valeur officielle Annexe C.3.1
     uint64_t pdf1_test = 0x11C662468AC5600ULL;
@@ -731,7 +948,7 @@ void test_cs_t001_vectors(void) {
 // PRIORITY 4: Improved Debug Output
 // =============================
 
-void debug_print_frame_analysis(volatile const uint8_t *frame) {
+void debug_print_frame_analysis(volatile const packed_frame_t *frame) {
     DEBUG_LOG_FLUSH("\r\n=== FRAME ANALYSIS (CS-T001 Bit Numbering) ===\r\n");
     
     // Frame structure breakdown
@@ -785,12 +1002,8 @@ void debug_print_frame_analysis(volatile const uint8_t *frame) {
     
     // Hex dump with proper formatting
     DEBUG_LOG_FLUSH("\r\n=== HEX DUMP (18 bytes) ===\r\n");
-    for (int byte = 0; byte < 18; byte++) {
-        uint8_t byte_val = 0;
-        for (int bit = 0; bit < 8; bit++) {
-            byte_val = (byte_val << 1) | frame[byte * 8 + bit];
-        }
-        debug_print_hex(byte_val);
+    for (int byte = 0; byte < MESSAGE_BYTES; byte++) {
+        debug_print_hex(FRAME_BYTE(*frame, byte));
         debug_print_char((byte + 1) % 8 == 0 ? '\r' : ' ');
         if ((byte + 1) % 8 == 0) debug_print_char('\n');
     }
@@ -820,6 +1033,7 @@ void cs_t001_full_compliance_check(void) {
     test_bch();
     test_bch_norm();
     test_cs_t001_vectors();
+    test_bch_table_equivalence();
     
     // 3. Position encoding verification  
     DEBUG_LOG_FLUSH("\r\n3. Position Encoding Validation:\r\n");
@@ -830,18 +1044,18 @@ void cs_t001_full_compliance_check(void) {
     DEBUG_LOG_FLUSH("\r\n4. Frame Construction & Analysis:\r\n");
     DEBUG_LOG_FLUSH("---------------------------------\r\n");
     build_compliant_frame();
-    debug_print_frame_analysis(beacon_frame);
+    debug_print_frame_analysis(&beacon_frame);
     
     // 5. Final verification
     DEBUG_LOG_FLUSH("\r\n5. Final Frame Verification:\r\n");
     DEBUG_LOG_FLUSH("----------------------------\r\n");
     
-    uint64_t pdf1_check = get_bit_field_volatile(beacon_frame, 25, 61);
-    uint32_t bch1_check = (uint32_t)get_bit_field_volatile(beacon_frame, 86, 21);
+    uint64_t pdf1_check = get_bit_field_volatile(&beacon_frame, 25, 61);
+    uint32_t bch1_check = (uint32_t)get_bit_field_volatile(&beacon_frame, 86, 21);
     uint32_t bch1_calc = compute_bch1(pdf1_check);
     
-    uint32_t pdf2_check = (uint32_t)get_bit_field_volatile(beacon_frame, 107, 26);
-    uint16_t bch2_check = (uint16_t)get_bit_field_volatile(beacon_frame, 133, 12);
+    uint32_t pdf2_check = (uint32_t)get_bit_field_volatile(&beacon_frame, 107, 26);
+    uint16_t bch2_check = (uint16_t)get_bit_field_volatile(&beacon_frame, 133, 12);
     uint16_t bch2_calc = compute_bch2(pdf2_check);
     
     DEBUG_LOG_FLUSH("BCH1 Frame Check: ");
@@ -860,9 +1074,7 @@ void cs_t001_full_compliance_check(void) {
     debug_print_hex16(bch2_check);
     DEBUG_LOG_FLUSH(")\r\n");
     
-    DEBUG_LOG_FLUSH("Frequency Deviation: ");
-    debug_print_float(get_freq_deviation(), 1);
-    DEBUG_LOG_FLUSH(" Hz\r\n");
+    telemetry_health_report();
     
     // Final status
     DEBUG_LOG_FLUSH("\r\n==================================================\r\n");
@@ -892,30 +1104,30 @@ void debug_print_complete_frame_info(uint8_t include_hex) {
     
     DEBUG_LOG_FLUSH("=== GPS DATA ===\r\n");
     DEBUG_LOG_FLUSH("Input: (");
-    debug_print_float(current_latitude, 6);
+    debug_print_gps_units(current_latitude);
     DEBUG_LOG_FLUSH(", ");
-    debug_print_float(current_longitude, 6);
+    debug_print_gps_units(current_longitude);
     DEBUG_LOG_FLUSH(")\r\n");
 
     // Extraction directe depuis la trame beacon_frame
-    uint32_t fine_pos = get_bit_field_volatile(beacon_frame, FRAME_POSITION_START, FRAME_POSITION_LENGTH);
+    uint32_t fine_pos = get_bit_field_volatile(&beacon_frame, FRAME_POSITION_START, FRAME_POSITION_LENGTH);
     DEBUG_LOG_FLUSH("19-bit: 0x");
     debug_print_hex24(fine_pos);
     DEBUG_LOG_FLUSH("\r\n");
 
-    uint32_t offset_pos = get_bit_field_volatile(beacon_frame, FRAME_OFFSET_START, FRAME_OFFSET_LENGTH);
+    uint32_t offset_pos = get_bit_field_volatile(&beacon_frame, FRAME_OFFSET_START, FRAME_OFFSET_LENGTH);
     DEBUG_LOG_FLUSH("18-bit offset: 0x");
     debug_print_hex24(offset_pos);
     DEBUG_LOG_FLUSH("\r\n");
 
     // BCH validation - dsPIC33CK optimized
-    uint64_t pdf1_data = get_bit_field_volatile(beacon_frame, 25, 61);
+    uint64_t pdf1_data = get_bit_field_volatile(&beacon_frame, 25, 61);
     uint32_t bch1_calc = compute_bch1(pdf1_data);
-    uint32_t bch1_recv = (uint32_t)get_bit_field_volatile(beacon_frame, 86, 21);
+    uint32_t bch1_recv = (uint32_t)get_bit_field_volatile(&beacon_frame, 86, 21);
     
-    uint32_t pdf2_data = (uint32_t)get_bit_field_volatile(beacon_frame, 107, 26);
+    uint32_t pdf2_data = (uint32_t)get_bit_field_volatile(&beacon_frame, 107, 26);
     uint16_t bch2_calc = compute_bch2(pdf2_data);
-    uint16_t bch2_recv = (uint16_t)get_bit_field_volatile(beacon_frame, 133, 12);
+    uint16_t bch2_recv = (uint16_t)get_bit_field_volatile(&beacon_frame, 133, 12);
     
     // Validation output
     DEBUG_LOG_FLUSH("=== FRAME VALIDATION ===\r\n");
@@ -944,25 +1156,21 @@ void debug_print_complete_frame_info(uint8_t include_hex) {
     // Conditional hex dump - dsPIC33CK optimized
     if (include_hex) {
         DEBUG_LOG_FLUSH("Frame HEX: ");
-        for (uint8_t byte = 0; byte < 18; byte++) {
-            uint8_t byte_val = 0;
-            for (uint8_t bit = 0; bit < 8; bit++) {
-                byte_val = (byte_val << 1) | (beacon_frame[byte * 8 + bit] & 1);
-            }
-            debug_print_hex(byte_val);
+        for (uint8_t byte = 0; byte < MESSAGE_BYTES; byte++) {
+            debug_print_hex(FRAME_BYTE(beacon_frame, byte));
         }
         DEBUG_LOG_FLUSH("\r\n");
     }
 }
 
 uint8_t validate_frame_hardware(void) {
-    uint64_t pdf1 = get_bit_field_volatile(beacon_frame, 25, 61);
+    uint64_t pdf1 = get_bit_field_volatile(&beacon_frame, 25, 61);
     uint32_t bch1_calc = compute_bch1(pdf1);
-    uint32_t bch1_recv = (uint32_t)get_bit_field_volatile(beacon_frame, 86, 21);
+    uint32_t bch1_recv = (uint32_t)get_bit_field_volatile(&beacon_frame, 86, 21);
     
-    uint32_t pdf2 = (uint32_t)get_bit_field_volatile(beacon_frame, 107, 26);
+    uint32_t pdf2 = (uint32_t)get_bit_field_volatile(&beacon_frame, 107, 26);
     uint16_t bch2_calc = compute_bch2(pdf2);
-    uint16_t bch2_recv = (uint16_t)get_bit_field_volatile(beacon_frame, 133, 12);
+    uint16_t bch2_recv = (uint16_t)get_bit_field_volatile(&beacon_frame, 133, 12);
     
     if(bch1_calc != bch1_recv || bch2_calc != bch2_recv) {
         DEBUG_LOG_FLUSH("FRAME VALIDATION ERROR\r\n");
@@ -991,17 +1199,8 @@ void initialize_debug_system(void) {
 // Version pour beacon_frame global
 void debug_print_beacon_frame_hex(void) {
     DEBUG_LOG_FLUSH("Frame HEX: ");
-    for (int byte = 0; byte < 18; byte++) {
-        uint8_t byte_val = 0;
-        for (int bit = 0; bit < 8; bit++) {
-            byte_val = (byte_val << 1) | beacon_frame[byte * 8 + bit];
-        }
-        debug_print_hex(byte_val);
+    for (uint8_t byte = 0; byte < MESSAGE_BYTES; byte++) {
+        debug_print_hex(FRAME_BYTE(beacon_frame, byte));
     }
     DEBUG_LOG_FLUSH("\r\n");
 }
-
-// Dummy implementation for debugging
-float get_freq_deviation(void) {
-    return 0.0f;
-}
\ No newline at end of file
@@ -12,9 +12,11 @@
 // =============================
 // Configuration du protocole CS-T001
 // =============================
-#define TEST_LATITUDE 42.95463
-#define TEST_LONGITUDE 1.364479
-#define TEST_ALTITUDE 1080
+// Positions en 1/10000 minute d'arc (int32), altitude en decimetres
+#define GPS_UNITS_PER_DEGREE 600000L
+#define TEST_LATITUDE  25772778L    // 42.95463 deg N
+#define TEST_LONGITUDE 818687L      // 1.364479 deg E (818687.4)
+#define TEST_ALTITUDE  10800L       // 1080 m
 
 // BCH Polynomials (CS-T001 compliant)
 #define BCH1_POLY       0x26D9E3  // 22-bit (X^21 + ... + 1)
@@ -27,6 +29,16 @@
 #define BCH2_DEGREE     12
 #define BCH2_DATA_BITS  26
 
+// Codewords for the decoder (bch_error_fix.c): frame bits START..END,
+// polynomial degree = END - frame bit
+#define BCH1_T              3       // BCH(82,61) corrects 3 bits
+#define BCH1_CODEWORD_BITS  82
+#define BCH1_CODEWORD_END   106
+#define BCH2_T              2       // BCH(38,26) corrects 2 bits
+#define BCH2_CODEWORD_BITS  38
+#define BCH2_CODEWORD_END   144
+#define BCH_SELFTEST_MAX_WEIGHT 3   // Largest error pattern swept by bch_selftest()
+
 #define PROTOCOL_ELT_DT 0x9 // 1001 binary
 
 // Frame sync patterns
@@ -36,10 +48,17 @@
 // Country code (France)
 #define COUNTRY_CODE_FRANCE 227
 
+// Default 26-bit beacon ID (single-beacon builds)
+#define BEACON_DEFAULT_ID 0x123456UL
+
 // Modes de balise
 #define BEACON_MODE_EXERCISE 0
 #define BEACON_MODE_TEST 1
 
+// Frame formats
+#define BEACON_FORMAT_FGB 0     // First generation, C/S T.001 (144 bits, Biphase-L)
+#define BEACON_FORMAT_SGB 1     // Second generation, C/S T.018 (250 bits, OQPSK/DSSS)
+
 // Validation des polynÃ´mes BCH
 #ifndef BCH_POLY_VALIDATED
 #define BCH_POLY_VALIDATED
@@ -72,6 +91,26 @@ typedef struct {
   uint32_t offset_position_18bit; // 4-second resolution offset
 } cs_gps_position_t;
 
+// Cached frame: static header written once, position/PDF-2 re-encoded
+// only when they change (one cache per beacon profile)
+typedef struct {
+  packed_frame_t frame;           // Complete frame, BCHs up to date
+  uint32_t beacon_id;             // 26-bit ID written in the header
+  uint16_t country;               // 10-bit country code
+  int32_t latitude;               // Inputs of the last encode (1e-4 min, dm)
+  int32_t longitude;
+  int32_t altitude;
+  uint32_t position_19bit;        // PDF-1 position currently encoded
+  uint32_t pdf2_26bit;            // PDF-2 data currently encoded
+  uint8_t mode;                   // beacon_mode the header was built for
+  uint8_t header_valid;           // 0 = rebuild everything
+} frame_cache_t;
+
+// frame_cache_update() result flags
+#define FRAME_CACHE_HEADER  0x01  // Static header rewritten
+#define FRAME_CACHE_PDF1    0x02  // Position + BCH1 re-encoded
+#define FRAME_CACHE_PDF2    0x04  // PDF-2 + BCH2 re-encoded
+
 // Test vector structure
 typedef struct {
   const char *name;
@@ -91,34 +130,44 @@ uint32_t compute_bch(uint64_t data, int num_bits, uint32_t poly, int poly_degree
 uint32_t compute_bch1(uint64_t data);
 uint16_t compute_bch2(uint32_t data);
 
+// Nibble feedback tables (program memory)
+extern const uint32_t bch1_nibble_table[16];
+extern const uint16_t bch2_nibble_table[16];
+
 // =============================
 // GPS Functions - Updated for Compliance
 // =============================
-void set_gps_position(double lat, double lon, double alt);
+void set_gps_position(int32_t lat, int32_t lon, int32_t alt);  // 1e-4 min, dm
 void parse_nmea_gga(const char *line);
+void nmea_parser_feed(char c);                 // Streaming GGA/RMC parser (one byte)
+void gps_uart_task(void);                      // Drain rxQueue into the NMEA parser
+uint16_t gps_fix_age_s(void);                  // Last NMEA fix, 0xFFFF = none since boot
 
 // PRIORITY 1: Fixed GPS encoding functions
-cs_gps_position_t encode_gps_position_complete(double lat, double lon);
-uint32_t compute_30min_position(double lat, double lon);
-uint32_t compute_4sec_offset(double lat, double lon, uint32_t position_30min);
-uint8_t altitude_to_code(double altitude);
+cs_gps_position_t encode_gps_position_complete(int32_t lat, int32_t lon);
+uint32_t compute_30min_position(int32_t lat, int32_t lon);
+uint32_t compute_4sec_offset(int32_t lat, int32_t lon, uint32_t position_30min);
+uint8_t altitude_to_code(int32_t altitude_dm);
 
 // =============================
 // Standardized Bit Operations
 // =============================
-void set_bit_field(uint8_t *frame, uint16_t cs_start_bit, uint8_t length,
+void set_bit_field(packed_frame_t *frame, uint16_t cs_start_bit, uint8_t length,
                    uint64_t value);
-uint64_t get_bit_field(const uint8_t *frame, uint16_t cs_start_bit,
+uint64_t get_bit_field(const packed_frame_t *frame, uint16_t cs_start_bit,
                        uint8_t length);
-uint64_t get_bit_field_volatile(volatile const uint8_t *frame,
+uint64_t get_bit_field_volatile(volatile const packed_frame_t *frame,
                                 uint16_t cs_start_bit, uint8_t length);
 
 // =============================
 // Frame Construction - Updated
 // =============================
-void build_test_frame(void);      // Original function
-void build_EXERCISE_frame(void);  // Original function
 void build_compliant_frame(void); // PRIORITY 2: New compliant version
+void frame_cache_init(frame_cache_t *cache, uint32_t beacon_id, uint16_t country);
+void frame_cache_invalidate(frame_cache_t *cache);
+uint8_t frame_cache_update(frame_cache_t *cache, uint8_t mode,
+                           int32_t lat, int32_t lon, int32_t alt);
+uint8_t frame_check_bch(const packed_frame_t *frame);  // 1 = BCH1 and BCH2 match
 
 // =============================
 // Comprehensive Testing
@@ -128,6 +177,7 @@ void validate_position_encoding(void);
 void test_bch(void);
 void test_bch_norm(void);
 void test_cs_t001_vectors(void);
+void test_bch_table_equivalence(void);
 void cs_t001_full_compliance_check(void); // Master check function
 
 // =============================
@@ -135,10 +185,10 @@ void cs_t001_full_compliance_check(void); // Master check function
 // =============================
 void debug_print_complete_frame_info(uint8_t include_hex);
 void debug_print_frame_hex(
-    volatile const uint8_t *frame); // Version parametree
+    volatile const packed_frame_t *frame); // Version parametree
 void debug_print_beacon_frame_hex(
     void); // Version utilisant beacon_frame global
-void debug_print_frame_analysis(volatile const uint8_t *frame);
+void debug_print_frame_analysis(volatile const packed_frame_t *frame);
 
 // Debug output functions for different data sizes
 void debug_print_hex24(uint32_t value);
@@ -146,8 +196,6 @@ void debug_print_hex16(uint16_t value);
 void debug_print_hex32(uint32_t value);
 void debug_print_hex64(uint64_t value);
 
-// Utility functions
-float get_freq_deviation(void); // Retourne la deviation de frequence en Hz
 
 // =============================
 // Fonction de reinitialisation des flags anti-doublons
@@ -156,7 +204,14 @@ void initialize_debug_system(void);
 uint8_t validate_frame_hardware(void);
 void set_debug_flag_atomic(uint8_t flag_bit);
 void full_error_diagnostic(void);
-void transmit_beacon_frame(void);
+
+// BCH decoder / error injection (bch_error_fix.c)
+int8_t bch1_correct(packed_frame_t *frame);     // Bits corrected, -1 = uncorrectable
+int8_t bch2_correct(packed_frame_t *frame);
+void frame_flip_bit(packed_frame_t *frame, uint16_t cs_bit);
+void bch_set_error_injection(uint8_t n1, uint8_t n2);   // Bits flipped per burst (0 = off)
+void bch_inject_errors(packed_frame_t *frame);
+uint8_t bch_selftest(void);                     // Exhaustive sweep, 1 = pass
 void debug_print_int16(int16_t value);
 void debug_print_hex24(uint32_t value);
 
@@ -165,14 +220,14 @@ void debug_print_hex24(uint32_t value);
 // =============================
 #define VALIDATE_CS_T001_FRAME()                                               \
   do {                                                                         \
-    uint64_t pdf1 = get_bit_field_volatile(beacon_frame, 25, 61);              \
+    uint64_t pdf1 = get_bit_field_volatile(&beacon_frame, 25, 61);             \
     uint32_t bch1_calc = compute_bch1(pdf1);                                   \
     uint32_t bch1_recv =                                                       \
-        (uint32_t)get_bit_field_volatile(beacon_frame, 86, 21);                \
-    uint32_t pdf2 = (uint32_t)get_bit_field_volatile(beacon_frame, 107, 26);   \
+        (uint32_t)get_bit_field_volatile(&beacon_frame, 86, 21);               \
+    uint32_t pdf2 = (uint32_t)get_bit_field_volatile(&beacon_frame, 107, 26);  \
     uint16_t bch2_calc = compute_bch2(pdf2);                                   \
     uint16_t bch2_recv =                                                       \
-        (uint16_t)get_bit_field_volatile(beacon_frame, 133, 12);               \
+        (uint16_t)get_bit_field_volatile(&beacon_frame, 133, 12);              \
     if ((bch1_calc != bch1_recv) || (bch2_calc != bch2_recv)) {                \
       debug_print_str("FRAME VALIDATION ERROR\r\n");                           \
       return 0;                                                                \
@@ -198,17 +253,14 @@ typedef enum {
     BEACON_EXERCISE_FRAME
 } beacon_frame_type_t;
 
-void start_beacon_frame(beacon_frame_type_t frame_type);
-
 
 // =============================
 // Variables globales partagees
 // =============================
-extern uint8_t frame[MESSAGE_BITS];
 extern volatile uint8_t gps_updated;
-extern double current_latitude;
-extern double current_longitude;
-extern double current_altitude;
+extern int32_t current_latitude;     // 1/10000 minute
+extern int32_t current_longitude;    // 1/10000 minute
+extern int32_t current_altitude;     // Decimeters
 
 // =============================
 // Convenience Macros for Frame Fields
@@ -5,6 +5,7 @@
 #include "includes.h"
 #include "rf_interface.h"
 #include "system_debug.h"
+#include "system_perf.h"
 
 // =============================
 // RF Hardware Pin Definitions
@@ -23,6 +24,9 @@
 #define ADF4351_LE_TRIS      TRISBbits.TRISB3
 #define ADF4351_CE_TRIS      TRISBbits.TRISB4
 #define ADF4351_RF_EN_TRIS   TRISBbits.TRISB5
+#define ADF4351_LD_PIN       PORTBbits.RB7    // Lock detect (input)
+#define ADF4351_LD_TRIS      TRISBbits.TRISB7
+#define RF_FREQ_SELECT_PIN   PORTBbits.RB13   // Channel switch (init_gpio: input, pull-down)
 
 // ADL5375 I/Q Modulator control pins (400 MHz - 6 GHz)
 #define ADL5375_ENABLE_PIN   LATBbits.LATB6   // Enable
@@ -41,25 +45,113 @@
 // ADF4351 register values for 403 MHz output
 // Calculated for 25 MHz reference clock
 // RFOUT = (REFIN × (INT + FRAC/MOD)) / RF_DIV
-static const uint32_t adf4351_regs_403mhz[] = {
-    0x200000,    // R0: N=16, FRAC=0 (403MHz = 25MHz × 16.12)
-    0x8000001,   // R1: Phase=0, MOD=1 
-    0x4E42,      // R2: LDF=0, LDP=1, PD_POL=1, CP=2.5mA
+static const uint32_t adf4351_regs_403mhz[ADF4351_NUM_REGS] = {
+    ADF4351_R0(403000UL),   // R0: INT=128, FRAC=3000 (403MHz x 8 = 25MHz x 128.96)
+    ADF4351_R1,             // R1: Prescaler 8/9, phase=1, MOD=3125
+    0x4E42,      // R2: LDF=0 (FRAC-N), LDP=10ns, PD_POL=1, CP=2.5mA
     0x4B3,       // R3: Clock divider, CSR
-    0x8C803C,    // R4: Output power=+5dBm, MTLD=0, VCO_PD=0, RF_DIV=1
-    0x580005     // R5: Reserved bits
+    0x8C803C | ((uint32_t)ADF4351_RF_DIV_SEL << 20),  // R4: +5dBm, MTLD=0, VCO_PD=0, RF_DIV=8
+    0x580005     // R5: LD pin = digital lock detect
 };
 
+// Channel plan: only R0/R1 differ, precomputed (see ADF4351_CHANNEL)
+static const rf_channel_t rf_channel_table[RF_CHANNEL_COUNT] = {
+    ADF4351_CHANNEL(403000UL),
+    ADF4351_CHANNEL(403025UL),
+    ADF4351_CHANNEL(403050UL),
+    ADF4351_CHANNEL(403075UL),
+    ADF4351_CHANNEL(403100UL),
+#if ADF4351_LAB_CHANNELS
+    ADF4351_CHANNEL(406025UL),
+    ADF4351_CHANNEL(406028UL),
+    ADF4351_CHANNEL(406031UL),
+    ADF4351_CHANNEL(406037UL),
+    ADF4351_CHANNEL(406040UL),
+#endif
+};
+
+_Static_assert(RF_CHANNEL_DEFAULT < RF_CHANNEL_COUNT && RF_CHANNEL_ALT < RF_CHANNEL_COUNT,
+               "RB13 channel outside the table");
+
 // =============================
 // Global RF State Variables
 // =============================
 static volatile uint8_t rf_amp_enabled = 0;              // RF amplifier state
 static volatile uint8_t rf_current_power_mode = RF_POWER_LOW;  // Current power mode
 
+// RF chain sequencer (advanced by rf_chain_task() from the main loop)
+static volatile rf_chain_state_t rf_chain_state = RF_CHAIN_OFF;  // Current stage
+static volatile uint8_t rf_chain_request = 0;            // Requested chain state (1 = on)
+static uint32_t rf_chain_stage_start = 0;                // Stage entry timestamp (ms)
+
+extern uint32_t timebase_millis(void);
+
+// Millisecond timebase (SCCP1)
+static uint32_t rf_now(void) {
+    return timebase_millis();
+}
+
+// Enter a sequencer stage and timestamp it
+static void rf_chain_enter(rf_chain_state_t state) {
+    rf_chain_stage_start = rf_now();
+    rf_chain_state = state;
+}
+
+// Stage elapsed for at least settle_ms (strict compare: 1 ms tick granularity)
+static uint8_t rf_chain_settled(uint32_t settle_ms) {
+    return (rf_now() - rf_chain_stage_start) > settle_ms;
+}
+
 // =============================
 // ADF4351 SPI Driver Functions
 // =============================
 
+// Shadow of the last value written to each register (control bits included)
+static uint32_t adf4351_shadow[ADF4351_NUM_REGS];
+static uint8_t adf4351_shadow_valid = 0;   // 0 until a full load has been done
+
+#if ADF4351_USE_HW_SPI
+// SPI1 master, 16-bit words, CKP=0/CKE=1 (ADF4351 samples on rising SCK)
+static void adf4351_spi_init(void) {
+    SPI1CON1Lbits.SPIEN = 0;
+    SPI1CON1L = 0;
+    SPI1CON1H = 0;
+    
+    __builtin_write_OSCCONL(OSCCONL | 0x40);  // Deverrouiller PPS
+    _RP33R = 0x0006;        // SCK1OUT sur RP33 (RB1)
+    _RP34R = 0x0005;        // SDO1 sur RP34 (RB2)
+    _SCK1R = 33;            // SCK1 input mapped back on RB1 (master mode)
+    __builtin_write_OSCCONL(OSCCONL & ~0x40); // Verrouiller PPS
+    
+    SPI1BRGL = (FCY / (2UL * ADF4351_SPI_CLOCK_HZ)) - 1;
+    SPI1STATLbits.SPIROV = 0;
+    
+    SPI1CON1Hbits.IGNROV = 1;   // Receive data never read
+    SPI1CON1Lbits.DISSDI = 1;   // SDI not used (no readback)
+    SPI1CON1Lbits.MODE16 = 1;   // 16-bit transfers: 2 per register
+    SPI1CON1Lbits.CKP = 0;      // Clock idle low
+    SPI1CON1Lbits.CKE = 1;      // Data changes on falling edge
+    SPI1CON1Lbits.MSTEN = 1;    // Master
+    SPI1CON1Lbits.SPIEN = 1;
+}
+
+static void adf4351_write_register(uint32_t reg_data) {
+    ADF4351_LE_PIN = 0;
+    
+    // Send 32 bits MSB first as two 16-bit words
+    while (SPI1STATLbits.SPITBF);
+    SPI1BUFL = (uint16_t)(reg_data >> 16);
+    while (SPI1STATLbits.SPITBF);
+    SPI1BUFL = (uint16_t)reg_data;
+    while (!SPI1STATLbits.SRMT);   // Last bit shifted out
+    
+    // Latch data into ADF4351 (t_LE >= 20 ns)
+    ADF4351_LE_PIN = 1;
+    __builtin_nop();
+    __builtin_nop();
+    ADF4351_LE_PIN = 0;
+}
+#else
 static void adf4351_spi_write_byte(uint8_t data) {
     for (int i = 7; i >= 0; i--) {
         ADF4351_CLK_PIN = 0;
@@ -86,6 +178,183 @@ static void adf4351_write_register(uint32_t reg_data) {
     __delay_us(10);     // Latch pulse width
     ADF4351_LE_PIN = 0;
 }
+#endif
+
+// Write only the registers that differ from the shadow copy (R5 -> R1),
+// then R0 whenever anything changed: R0 triggers the double-buffered
+// fields (R1 MOD/phase, R4 RF divider) and the VCO band select.
+uint8_t rf_adf4351_program(const uint32_t *regs) {
+    uint8_t written = 0;
+    
+    for (int i = ADF4351_NUM_REGS - 1; i >= 1; i--) {
+        uint32_t value = (regs[i] & ~0x7UL) | (uint32_t)i;
+        if (!adf4351_shadow_valid || value != adf4351_shadow[i]) {
+            adf4351_write_register(value);
+            adf4351_shadow[i] = value;
+            written++;
+        }
+    }
+    
+    uint32_t r0 = regs[0] & ~0x7UL;
+    if (!adf4351_shadow_valid || written || r0 != adf4351_shadow[0]) {
+        adf4351_write_register(r0);
+        adf4351_shadow[0] = r0;
+        written++;
+    }
+    
+    adf4351_shadow_valid = 1;
+    return written;
+}
+
+// Between bursts: keep the PLL locked (default) or power it down via CE
+static uint8_t adf4351_held_down = 0;
+static uint8_t rf_channel = RF_CHANNEL_DEFAULT;
+static uint8_t rf_switch_state = 0;         // RB13 at the last poll
+static uint16_t rf_lock_us = 0;             // Last measured lock time
+static uint16_t rf_lock_losses = 0;         // LD dropped while the chain was up
+static uint8_t rf_ld_state = 1;
+
+// Relock since the last rf_adf4351_relock_take() (burst telemetry)
+#define RF_RELOCK_NONE      0
+#define RF_RELOCK_PENDING   1               // Registers loaded, LD polled by rf_chain_task()
+#define RF_RELOCK_DONE      2
+static uint8_t rf_relock_state = RF_RELOCK_NONE;
+static uint16_t rf_relock_us;
+static uint32_t rf_relock_start;            // ms, RF_RELOCK_PENDING only
+
+static void rf_relock_done(uint16_t lock_us) {
+    rf_lock_us = lock_us;
+    rf_relock_us = lock_us;
+    rf_relock_state = RF_RELOCK_DONE;
+}
+
+// Poll LD until the PLL reports lock: time in us, or ADF4351_LOCK_FAILED
+static uint16_t adf4351_wait_lock(void) {
+    for (uint16_t t = 0; t < ADF4351_LOCK_TIMEOUT_US; t += ADF4351_LOCK_POLL_US) {
+        if (ADF4351_LD_PIN) return t;
+        __delay_us(ADF4351_LOCK_POLL_US);
+    }
+    return ADF4351_LOCK_FAILED;
+}
+
+void rf_adf4351_hold(uint8_t mode) {
+    ADF4351_RF_EN_PIN = 0;          // No RF output while idle
+    if (mode == RF_HOLD_POWER_DOWN) {
+        ADF4351_CE_PIN = 0;         // Chip power-down, charge pump three-state
+        adf4351_held_down = 1;
+    }
+}
+
+// Registers are reloaded from the shadow copy; lock takes RF_PLL_RELOCK_MS
+void rf_adf4351_resume(void) {
+    uint32_t regs[ADF4351_NUM_REGS];
+    
+    if (!adf4351_held_down) return;
+    ADF4351_CE_PIN = 1;
+    memcpy(regs, adf4351_shadow, sizeof(regs));
+    adf4351_shadow_valid = 0;       // Force the full R5..R0 load
+    rf_adf4351_program(regs);
+    adf4351_held_down = 0;
+    rf_relock_start = rf_now();     // No busy wait here: LD polled every 1 ms
+    rf_relock_state = RF_RELOCK_PENDING;
+}
+
+// Output power on RFOUTA: 0..3 = -4/-1/+2/+5 dBm (R4 bits [4:3])
+void rf_adf4351_set_output_power(uint8_t level) {
+    uint32_t regs[ADF4351_NUM_REGS];
+    
+    if (level > 3) level = 3;
+    memcpy(regs, adf4351_shadow, sizeof(regs));
+    regs[4] = (regs[4] & ~(0x3UL << 3)) | ((uint32_t)level << 3);
+    rf_adf4351_program(regs);   // R4 + R0 only
+}
+
+// Fast retune: R1 (unchanged across the plan) and R0 only, then wait for
+// LD instead of a fixed delay. RF output stays as it is: call with tx idle.
+uint8_t rf_adf4351_set_channel(uint8_t ch) {
+    uint32_t regs[ADF4351_NUM_REGS];
+    
+    if (ch >= RF_CHANNEL_COUNT) return 0;
+    rf_channel = ch;
+    memcpy(regs, adf4351_shadow, sizeof(regs));
+    regs[1] = rf_channel_table[ch].r1;
+    regs[0] = rf_channel_table[ch].r0;
+    
+    if (adf4351_held_down) {
+        memcpy(adf4351_shadow, regs, sizeof(regs));   // Loaded by rf_adf4351_resume()
+        return 1;
+    }
+    if (rf_adf4351_program(regs) == 0) return 1;       // Already there
+    
+    rf_relock_done(adf4351_wait_lock());
+    if (rf_lock_us == ADF4351_LOCK_FAILED) {
+        DEBUG_LOG_FLUSH("ADF4351: no lock after retune\r\n");
+        return 0;
+    }
+    return 1;
+}
+
+uint8_t rf_adf4351_get_channel(void) {
+    return rf_channel;
+}
+
+uint32_t rf_adf4351_channel_khz(uint8_t ch) {
+    return (ch < RF_CHANNEL_COUNT) ? rf_channel_table[ch].freq_khz : 0;
+}
+
+uint16_t rf_adf4351_lock_time_us(void) {
+    return rf_lock_us;
+}
+
+uint8_t rf_adf4351_locked(void) {
+    return ADF4351_LD_PIN;
+}
+
+uint16_t rf_adf4351_lock_losses(void) {
+    return rf_lock_losses;
+}
+
+// Still pending when read: LD never came up, counted as a failure
+uint8_t rf_adf4351_relock_take(uint16_t *lock_us) {
+    uint8_t state = rf_relock_state;
+    
+    if (state == RF_RELOCK_NONE) return 0;
+    *lock_us = (state == RF_RELOCK_DONE) ? rf_relock_us : ADF4351_LOCK_FAILED;
+    rf_relock_state = RF_RELOCK_NONE;
+    return 1;
+}
+
+// Switch changes only: a CHAN command holds until RB13 is moved
+void rf_channel_poll_switch(void) {
+    uint8_t state = RF_FREQ_SELECT_PIN;
+    if (state == rf_switch_state) return;
+    rf_switch_state = state;
+    rf_adf4351_set_channel(state ? RF_CHANNEL_ALT : RF_CHANNEL_DEFAULT);
+}
+
+// CHAN: channel list | CHAN <n>: retune
+void rf_channel_command(const char *args) {
+    while (*args == ' ') args++;
+    if (*args != '\0') {
+        uint8_t ch = (uint8_t)strtoul(args, NULL, 10);
+        if (ch >= RF_CHANNEL_COUNT) {
+            DEBUG_LOG_FLUSH("CHAN: no such channel\r\n");
+            return;
+        }
+        rf_adf4351_set_channel(ch);
+    }
+    for (uint8_t i = 0; i < RF_CHANNEL_COUNT; i++) {
+        DEBUG_LOG_FLUSH(i == rf_channel ? "* " : "  ");
+        debug_print_uint16(i);
+        DEBUG_LOG_FLUSH(": ");
+        debug_print_uint32(rf_channel_table[i].freq_khz);
+        DEBUG_LOG_FLUSH(" kHz\r\n");
+    }
+    DEBUG_LOG_FLUSH("Lock ");
+    if (rf_lock_us == ADF4351_LOCK_FAILED) DEBUG_LOG_FLUSH("FAILED");
+    else debug_print_uint16(rf_lock_us);
+    DEBUG_LOG_FLUSH(" us\r\n");
+}
 
 // =============================
 // Public RF Interface Functions
@@ -98,6 +367,7 @@ void rf_init_adf4351(void) {
     ADF4351_LE_TRIS = 0;
     ADF4351_CE_TRIS = 0;
     ADF4351_RF_EN_TRIS = 0;
+    ADF4351_LD_TRIS = 1;
     
     // Set initial pin states
     ADF4351_CLK_PIN = 0;
@@ -108,14 +378,22 @@ void rf_init_adf4351(void) {
     
     __delay_ms(10);         // Power-up delay
     
-    // Program ADF4351 registers (R5 to R0 sequence)
-    for (int i = 5; i >= 0; i--) {
-        adf4351_write_register(adf4351_regs_403mhz[i] | i);
-    }
+#if ADF4351_USE_HW_SPI
+    adf4351_spi_init();
+#endif
     
-    __delay_ms(20);         // Wait for PLL lock
+    // Program ADF4351 registers (full R5 to R0 load, seeds the shadow copy)
+    adf4351_shadow_valid = 0;
+    rf_adf4351_program(adf4351_regs_403mhz);
+    rf_relock_done(adf4351_wait_lock());
     
-    DEBUG_LOG_FLUSH("ADF4351 initialized @ 403 MHz\r\n");
+    // Channel from the RB13 switch (R0 only if not the 403.000 default)
+    rf_switch_state = RF_FREQ_SELECT_PIN;
+    rf_adf4351_set_channel(rf_switch_state ? RF_CHANNEL_ALT : RF_CHANNEL_DEFAULT);
+    
+    DEBUG_LOG_FLUSH("ADF4351 initialized @ ");
+    debug_print_uint32(rf_channel_table[rf_channel].freq_khz);
+    DEBUG_LOG_FLUSH(rf_lock_us == ADF4351_LOCK_FAILED ? " kHz, NO LOCK\r\n" : " kHz\r\n");
 }
 
 void rf_adf4351_enable_output(uint8_t state) {
@@ -123,12 +401,9 @@ void rf_adf4351_enable_output(uint8_t state) {
     DEBUG_LOG_FLUSH(state ? "ADF4351 RF output ON\r\n" : "ADF4351 RF output OFF\r\n");
 }
 
-<<<<<<< HEAD
 //============================
 // ADL5375 RF MOdule
 //============================
-=======
->>>>>>> bbbf4ea6376c32d04d173795899fc7ca2c70e198
 void rf_init_adl5375(void) {
     // Configure ADL5375 enable pin
     ADL5375_ENABLE_TRIS = 0;    // Output
@@ -138,19 +413,13 @@ void rf_init_adl5375(void) {
 }
 
 void rf_adl5375_enable(uint8_t state) {
-    ADL5375_ENABLE_PIN = state ? 1 : 0;
-    if (state) {
-        __delay_ms(10);     // ADL5375 settling time
-    }
+    ADL5375_ENABLE_PIN = state ? 1 : 0;   // Settling handled by the RF chain sequencer
     DEBUG_LOG_FLUSH(state ? "ADL5375 enabled\r\n" : "ADL5375 disabled\r\n");
 }
 
-<<<<<<< HEAD
 //============================
 // RA07M4047M RF Power Amplifier
 //============================
-=======
->>>>>>> bbbf4ea6376c32d04d173795899fc7ca2c70e198
 void rf_init_power_amplifier(void) {
     static uint8_t initialized = 0;
     if (initialized) return;
@@ -177,8 +446,10 @@ void rf_set_power_level(uint8_t mode) {
     
     // Only change if different from current mode
     if (mode != rf_current_power_mode) {
+        uint8_t was_enabled = rf_chain_request;
+        
         // Disable amplifier during power level transition
-        if (rf_amp_enabled) {
+        if (was_enabled) {
             rf_control_amplifier_chain(0);
             __delay_us(50);
         }
@@ -187,54 +458,113 @@ void rf_set_power_level(uint8_t mode) {
         POWER_CTRL_PIN = (mode == RF_POWER_HIGH) ? 1 : 0;
         rf_current_power_mode = mode;
         
-        // Re-enable amplifier if it was previously enabled
-        if (rf_amp_enabled) {
+        // Re-enable amplifier if it was previously enabled (sequenced)
+        if (was_enabled) {
             __delay_us(50);
             rf_control_amplifier_chain(1);
         }
     }
 }
 
+// Non-blocking request: callable from main context or from the Timer1 ISR.
+// Power-up is sequenced by rf_chain_task(); power-down drops the PA at once
+// and lets the task switch off the modulator and LO afterwards.
 void rf_control_amplifier_chain(uint8_t state) {
+    PERF_BEGIN(perf_t0);
+    
     if (state) {
-        // RF chain power-up sequence (proper order for stability)
-        
-        // 1. Enable ADF4351 LO output first
-        rf_adf4351_enable_output(1);
-        __delay_ms(10);             // Wait for LO frequency stability
-        
-        // 2. Enable ADL5375 I/Q modulator
-        rf_adl5375_enable(1);
-        __delay_ms(5);              // ADL5375 enable settling time
-        
-        // 3. Enable RA07M4047M power amplifier (last in chain)
-        AMP_ENABLE_PIN = 1;
-        __delay_us(500);            // PA enable settling time
-        rf_amp_enabled = 1;
-        
-        // Debug confirmation
-        DEBUG_LOG_FLUSH("RF Chain ENABLED (");
-        DEBUG_LOG_FLUSH((rf_current_power_mode == RF_POWER_HIGH) ? "HIGH" : "LOW");
-        DEBUG_LOG_FLUSH(" power, 403 MHz)\r\n");
-        
+        rf_chain_request = 1;
+        if (rf_chain_state == RF_CHAIN_OFF || rf_chain_state == RF_CHAIN_SHUTDOWN) {
+            // 1. Enable ADF4351 LO output first (pin only, no logging here)
+            ADF4351_RF_EN_PIN = 1;
+            rf_chain_enter(RF_CHAIN_LO_SETTLE);
+        }
     } else {
-        // RF chain power-down sequence (reverse order for safety)
-        
-        // 1. Disable power amplifier first (prevent overdrive)
-        AMP_ENABLE_PIN = 0;
-        __delay_us(100);
-        
-        // 2. Disable I/Q modulator
-        rf_adl5375_enable(0);
-        
-        // 3. Disable LO output (keep PLL running, just RF off)
-        rf_adf4351_enable_output(0);
-        
-        rf_amp_enabled = 0;
-        DEBUG_LOG_FLUSH("RF Chain DISABLED\r\n");
+        rf_chain_request = 0;
+        if (rf_chain_state != RF_CHAIN_OFF) {
+            // 1. Disable power amplifier first (prevent overdrive)
+            AMP_ENABLE_PIN = 0;
+            rf_amp_enabled = 0;
+            rf_chain_state = RF_CHAIN_SHUTDOWN;
+        }
+    }
+    
+    PERF_END(PERF_RF_CHAIN, perf_t0);
+}
+
+void rf_chain_task(void) {
+    // Relock after rf_adf4351_resume(): upper bound, 1 ms steps
+    if (rf_relock_state == RF_RELOCK_PENDING) {
+        uint32_t elapsed = rf_now() - rf_relock_start;
+        if (ADF4351_LD_PIN) {
+            rf_relock_done((uint16_t)((elapsed + 1) * 1000UL));
+        } else if (elapsed > RF_PLL_RELOCK_MS) {
+            rf_relock_done(ADF4351_LOCK_FAILED);
+            DEBUG_LOG_FLUSH("ADF4351: no lock after resume\r\n");
+        }
+    }
+    
+    switch (rf_chain_state) {
+        case RF_CHAIN_LO_SETTLE:
+            // Wait for LO frequency stability, then enable ADL5375
+            if (rf_chain_settled(RF_LO_SETTLE_MS)) {
+                ADL5375_ENABLE_PIN = 1;
+                rf_chain_enter(RF_CHAIN_MOD_SETTLE);
+            }
+            break;
+            
+        case RF_CHAIN_MOD_SETTLE:
+            // ADL5375 settling, then enable RA07M4047M (last in chain)
+            if (rf_chain_settled(RF_MOD_SETTLE_MS)) {
+                AMP_ENABLE_PIN = 1;
+                rf_chain_enter(RF_CHAIN_PA_SETTLE);
+            }
+            break;
+            
+        case RF_CHAIN_PA_SETTLE:
+            if (rf_chain_settled(RF_PA_SETTLE_MS)) {
+                rf_amp_enabled = 1;
+                rf_chain_state = RF_CHAIN_READY;   // Timer1 may start the ramp
+                rf_ld_state = 1;                   // Unlocked already: one loss
+                
+                DEBUG_LOG_FLUSH("RF Chain ENABLED (");
+                DEBUG_LOG_FLUSH((rf_current_power_mode == RF_POWER_HIGH) ? "HIGH" : "LOW");
+                DEBUG_LOG_FLUSH(" power, ");
+                debug_print_uint32(rf_channel_table[rf_channel].freq_khz);
+                DEBUG_LOG_FLUSH(" kHz)\r\n");
+            }
+            break;
+            
+        case RF_CHAIN_SHUTDOWN:
+            // PA already off: disable I/Q modulator, then LO output (PLL keeps running)
+            rf_adl5375_enable(0);
+            rf_adf4351_enable_output(0);
+            rf_chain_state = RF_CHAIN_OFF;
+            DEBUG_LOG_FLUSH("RF Chain DISABLED\r\n");
+            break;
+            
+        case RF_CHAIN_READY:
+            // Lock loss during the burst (1 ms polling): counted per falling edge
+            if (ADF4351_LD_PIN != rf_ld_state) {
+                rf_ld_state = ADF4351_LD_PIN;
+                if (!rf_ld_state) rf_lock_losses++;
+            }
+            break;
+            
+        case RF_CHAIN_OFF:
+        default:
+            break;
     }
 }
 
+uint8_t rf_chain_ready(void) {
+    return rf_chain_state == RF_CHAIN_READY;
+}
+
+rf_chain_state_t rf_chain_get_state(void) {
+    return rf_chain_state;
+}
+
 void rf_initialize_all_modules(void) {
     DEBUG_LOG_FLUSH("Initializing RF modules...\r\n");
     
@@ -259,8 +589,13 @@ uint8_t rf_get_power_mode(void) {
 }
 
 void rf_system_halt(const char* message) {
-    // Disable all RF outputs for safety
-    rf_control_amplifier_chain(0);
+    // Disable all RF outputs for safety (immediate, no sequencing)
+    AMP_ENABLE_PIN = 0;
+    ADL5375_ENABLE_PIN = 0;
+    ADF4351_RF_EN_PIN = 0;
+    rf_amp_enabled = 0;
+    rf_chain_request = 0;
+    rf_chain_state = RF_CHAIN_OFF;
     
     // Enter infinite loop with error message
     while(1) {
@@ -269,8 +604,4 @@ void rf_system_halt(const char* message) {
         DEBUG_LOG_FLUSH("\r\n");
         __delay_ms(1000);
     }
-<<<<<<< HEAD
-}
-=======
 }
->>>>>>> bbbf4ea6376c32d04d173795899fc7ca2c70e198
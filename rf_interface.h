@@ -10,11 +10,116 @@
 #define RF_POWER_LOW  0     // 100mW mode for local tests
 #define RF_POWER_HIGH 1     // 5W mode for exercises
 
+// =============================
+// RF Chain Power Sequencer
+// =============================
+#define RF_LO_SETTLE_MS   10   // ADF4351 LO frequency stability
+#define RF_MOD_SETTLE_MS  15   // ADL5375 enable settling
+#define RF_PA_SETTLE_MS   1    // RA07M4047M enable settling (>= 500 us)
+
+typedef enum {
+    RF_CHAIN_OFF = 0,       // PA, modulator and LO output disabled
+    RF_CHAIN_LO_SETTLE,     // LO output on, waiting for stability
+    RF_CHAIN_MOD_SETTLE,    // ADL5375 on, settling
+    RF_CHAIN_PA_SETTLE,     // PA on, settling
+    RF_CHAIN_READY,         // Chain up - ramp-up may start
+    RF_CHAIN_SHUTDOWN       // PA off, modulator/LO pending
+} rf_chain_state_t;
+
 // =============================
 // ADF4351 PLL Synthesizer Functions
 // =============================
+#ifndef ADF4351_USE_HW_SPI
+#define ADF4351_USE_HW_SPI   1           // 1 = SPI1 peripheral, 0 = bit-bang fallback
+#endif
+#define ADF4351_SPI_CLOCK_HZ 5000000UL   // SCK (ADF4351 max 20 MHz)
+#define ADF4351_NUM_REGS     6           // R0..R5
+
+// ADF4351 state between bursts
+#define RF_HOLD_LOCKED       0           // PLL kept running and locked, RF output off
+#define RF_HOLD_POWER_DOWN   1           // CE low, reloaded and relocked on resume
+#ifndef RF_IDLE_HOLD_MODE
+#define RF_IDLE_HOLD_MODE    RF_HOLD_LOCKED
+#endif
+#define RF_PLL_RELOCK_MS     20          // Lock time after power-down (worst case, resume)
+
+// Lock detect: LD pin (R5 LD mode = digital lock detect) on RB7, polled
+#define ADF4351_LOCK_POLL_US     10
+#define ADF4351_LOCK_TIMEOUT_US  5000    // Datasheet lock time is well under 1 ms
+#define ADF4351_LOCK_FAILED      0xFFFF  // rf_adf4351_lock_time_us(): no lock
+
+// =============================
+// ADF4351 Channel Plan
+// =============================
+// 25 MHz reference, R = 1 (PFD 25 MHz), RF divider /8: VCO = 8 x RFOUT,
+// 3.22-3.25 GHz. MOD = 3125 puts the fractional grid at 1 kHz on RFOUT,
+// so every channel below is exact. R0/R1 are built by the preprocessor.
+#define ADF4351_REFIN_HZ     25000000UL
+#define ADF4351_PFD_HZ       ADF4351_REFIN_HZ
+#define ADF4351_RF_DIV       8
+#define ADF4351_RF_DIV_SEL   3           // R4 [22:20] = log2(ADF4351_RF_DIV)
+#define ADF4351_MOD          3125UL
+
+#define ADF4351_VCO_HZ(khz)  ((uint32_t)(khz) * 1000UL * ADF4351_RF_DIV)
+#define ADF4351_INT(khz)     (ADF4351_VCO_HZ(khz) / ADF4351_PFD_HZ)
+#define ADF4351_FRAC(khz)    ((ADF4351_VCO_HZ(khz) % ADF4351_PFD_HZ) / (ADF4351_PFD_HZ / ADF4351_MOD))
+#define ADF4351_R0(khz)      ((ADF4351_INT(khz) << 15) | (ADF4351_FRAC(khz) << 3))
+#define ADF4351_R1           ((1UL << 27) | (1UL << 15) | (ADF4351_MOD << 3) | 1UL)  // Prescaler 8/9, phase 1
+#define ADF4351_CHANNEL(khz) { (khz), ADF4351_R0(khz), ADF4351_R1 }
+
+_Static_assert(ADF4351_PFD_HZ / ADF4351_MOD == 1000UL * ADF4351_RF_DIV, "Fractional step is not 1 kHz on RFOUT");
+_Static_assert(ADF4351_MOD >= 2 && ADF4351_MOD <= 4095, "ADF4351 MOD out of range");
+_Static_assert(ADF4351_INT(403000UL) >= 75, "INT below the 8/9 prescaler minimum");
+
+// 406.x channels radiate in the real COSPAS-SARSAT band: shielded lab only
+#ifndef ADF4351_LAB_CHANNELS
+#define ADF4351_LAB_CHANNELS 0
+#endif
+
+typedef enum {
+    RF_CH_403_000 = 0,      // Training channels (radiosonde band)
+    RF_CH_403_025,
+    RF_CH_403_050,
+    RF_CH_403_075,
+    RF_CH_403_100,
+#if ADF4351_LAB_CHANNELS
+    RF_CH_406_025,          // T.001 channels B, C, E, G, H
+    RF_CH_406_028,
+    RF_CH_406_031,
+    RF_CH_406_037,
+    RF_CH_406_040,
+#endif
+    RF_CHANNEL_COUNT
+} rf_channel_id_t;
+
+#ifndef RF_CHANNEL_DEFAULT
+#define RF_CHANNEL_DEFAULT   RF_CH_403_000   // RB13 low
+#endif
+#ifndef RF_CHANNEL_ALT
+#define RF_CHANNEL_ALT       RF_CH_403_050   // RB13 high
+#endif
+
+typedef struct {
+    uint32_t freq_khz;
+    uint32_t r0;                        // INT/FRAC, control bits 000
+    uint32_t r1;                        // Prescaler/phase/MOD, control bits 001
+} rf_channel_t;
+
 void rf_init_adf4351(void);                    // Initialize ADF4351 @ 403 MHz
 void rf_adf4351_enable_output(uint8_t state);  // Enable/disable RF output
+uint8_t rf_adf4351_program(const uint32_t *regs); // Delta write R5..R0, returns count
+void rf_adf4351_hold(uint8_t mode);            // Idle hold (RF_HOLD_LOCKED / RF_HOLD_POWER_DOWN)
+void rf_adf4351_resume(void);                  // Leave hold (relock: RF_PLL_RELOCK_MS)
+void rf_adf4351_set_output_power(uint8_t level);  // RFOUTA power 0..3 (R4 + R0)
+uint8_t rf_adf4351_set_channel(uint8_t ch);    // Fast retune (R1/R0 + lock detect), tx idle; 1 = locked
+uint8_t rf_adf4351_get_channel(void);
+uint32_t rf_adf4351_channel_khz(uint8_t ch);   // 0 = no such channel
+uint16_t rf_adf4351_lock_time_us(void);        // Last retune (ADF4351_LOCK_FAILED = timeout)
+uint8_t rf_adf4351_locked(void);               // LD pin now
+uint16_t rf_adf4351_lock_losses(void);         // LD falling edges with the chain up, since boot
+uint8_t rf_adf4351_relock_take(uint16_t *lock_us);  // Relock since the last call: 1 + time (or FAILED), 0 = none
+void rf_channel_poll_switch(void);             // RB13 changed: retune (burst start)
+void rf_channel_command(const char *args);     // UART: CHAN | CHAN <n>
 
 // =============================
 // ADL5375 I/Q Modulator Functions
@@ -27,7 +132,10 @@ void rf_adl5375_enable(uint8_t state);         // Enable/disable modulator
 // =============================
 void rf_init_power_amplifier(void);            // Initialize PA control
 void rf_set_power_level(uint8_t mode);         // Set power level (LOW/HIGH)
-void rf_control_amplifier_chain(uint8_t state);// Enable/disable complete RF chain
+void rf_control_amplifier_chain(uint8_t state);// Request RF chain on/off (non-blocking)
+void rf_chain_task(void);                      // Advance sequencer (main loop)
+uint8_t rf_chain_ready(void);                  // Chain settled, TX may ramp up
+rf_chain_state_t rf_chain_get_state(void);     // Current sequencer stage
 
 // =============================
 // Master RF Control Functions
@@ -0,0 +1,203 @@
+/* sgb_frame.c - Second-generation (C/S T.018) frame, BCH(250,202) and DSSS chips
+ * The 202-bit main + rotating field is built from the same inputs as the
+ * T.001 frame cache and protected by a 48-bit BCH computed a nibble at a
+ * time. The renderer spreads the 300 transmitted bits (50 preamble zeros
+ * + 250 message bits) over the I and Q PRN sequences, 256 chips per bit,
+ * and writes one OQPSK half-chip per sample: Q lags I by Tc/2.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "protocol_data.h"
+#include "sgb_frame.h"
+
+// =============================
+// Tables (program memory)
+// =============================
+// BCH register feedback after clocking one nibble out of the top:
+// (t * x^48) mod g(x), generated from SGB_BCH_POLY
+const uint64_t sgb_bch_nibble_table[16] = {
+    0x000000000000ULL, 0xC7EB85DF3C97ULL, 0x483C8E6145B9ULL, 0x8FD70BBE792EULL,
+    0x90791CC28B72ULL, 0x5792991DB7E5ULL, 0xD84592A3CECBULL, 0x1FAE177CF25CULL,
+    0xE719BC5A2A73ULL, 0x20F2398516E4ULL, 0xAF25323B6FCAULL, 0x68CEB7E4535DULL,
+    0x7760A098A101ULL, 0xB08B25479D96ULL, 0x3F5C2EF9E4B8ULL, 0xF8B7AB26D82FULL
+};
+
+// The 16 chips that follow the 23 in the register, s[n] = s[n-5] ^ s[n-23],
+// are linear in the register: XOR of one entry per register nibble (bits
+// 0-3, 4-7, ... 20-22). Generated by stepping the LFSR chip by chip.
+const uint16_t sgb_prn_nibble_table[6][16] = {
+    { 0x0000, 0x0842, 0x1084, 0x18C6, 0x2108, 0x294A, 0x318C, 0x39CE,
+      0x4210, 0x4A52, 0x5294, 0x5AD6, 0x6318, 0x6B5A, 0x739C, 0x7BDE },
+    { 0x0000, 0x8421, 0x0000, 0x8421, 0x0000, 0x8421, 0x0000, 0x8421,
+      0x0001, 0x8420, 0x0001, 0x8420, 0x0001, 0x8420, 0x0001, 0x8420 },
+    { 0x0000, 0x0002, 0x0004, 0x0006, 0x0008, 0x000A, 0x000C, 0x000E,
+      0x0010, 0x0012, 0x0014, 0x0016, 0x0018, 0x001A, 0x001C, 0x001E },
+    { 0x0000, 0x0021, 0x0042, 0x0063, 0x0084, 0x00A5, 0x00C6, 0x00E7,
+      0x0108, 0x0129, 0x014A, 0x016B, 0x018C, 0x01AD, 0x01CE, 0x01EF },
+    { 0x0000, 0x0210, 0x0421, 0x0631, 0x0842, 0x0A52, 0x0C63, 0x0E73,
+      0x1084, 0x1294, 0x14A5, 0x16B5, 0x18C6, 0x1AD6, 0x1CE7, 0x1EF7 },
+    { 0x0000, 0x2108, 0x4210, 0x6318, 0x8421, 0xA529, 0xC631, 0xE739,   // 3 bits only
+      0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+};
+
+// =============================
+// Bit fields (T.018 numbering, bit 1 = MSB of w[0])
+// =============================
+static void sgb_set_field(sgb_frame_t *frame, uint16_t start_bit, uint8_t length, uint64_t value) {
+    for (uint16_t idx = start_bit - 1; length; idx++) {
+        uint16_t mask = (uint16_t)(0x8000u >> (idx & 0x0F));
+        if ((value >> --length) & 1) frame->w[idx >> 4] |= mask;
+        else frame->w[idx >> 4] &= (uint16_t)~mask;
+    }
+}
+
+static uint64_t sgb_get_field(const sgb_frame_t *frame, uint16_t start_bit, uint8_t length) {
+    uint64_t value = 0;
+    for (uint16_t idx = start_bit - 1; length; idx++, length--) {
+        value = (value << 1) | FRAME_BIT(*frame, idx);
+    }
+    return value;
+}
+
+// =============================
+// BCH(250,202)
+// =============================
+// Systematic parity: info(x) * x^48 mod g(x). Bits 1-200 are 50 aligned
+// nibbles, bits 201-202 go through bit by bit.
+uint64_t sgb_compute_bch(const sgb_frame_t *frame) {
+    const uint64_t mask = (1ULL << SGB_BCH_BITS) - 1;
+    uint64_t reg = 0;
+
+    for (uint16_t n = 0; n < SGB_INFO_BITS / 4; n++) {
+        uint8_t nib = (uint8_t)(frame->w[n >> 2] >> (12 - 4 * (n & 3))) & 0x0F;
+        reg = ((reg << 4) & mask) ^ sgb_bch_nibble_table[(uint8_t)(reg >> 44) ^ nib];
+    }
+    for (uint16_t idx = SGB_INFO_BITS & ~3u; idx < SGB_INFO_BITS; idx++) {
+        uint8_t fb = (uint8_t)(reg >> 47) ^ FRAME_BIT(*frame, idx);
+        reg = (reg << 1) & mask;
+        if (fb) reg ^= SGB_BCH_POLY & mask;
+    }
+    return reg;
+}
+
+uint8_t sgb_frame_check_bch(const sgb_frame_t *frame) {
+    return sgb_compute_bch(frame) == sgb_get_field(frame, SGB_BCH_START, SGB_BCH_BITS);
+}
+
+// =============================
+// Frame encoding
+// =============================
+// Flag | degrees | 15-bit fraction from 1e-4 minute (rounded to 1/32768 deg)
+static uint32_t sgb_encode_coord(int32_t v, uint8_t deg_bits) {
+    uint8_t neg = (v < 0);
+    uint32_t a = neg ? (uint32_t)(-v) : (uint32_t)v;
+    uint32_t u = (uint32_t)(((uint64_t)a * 32768ULL + GPS_UNITS_PER_DEGREE / 2) / GPS_UNITS_PER_DEGREE);
+    return ((uint32_t)neg << (deg_bits + 15)) | u;
+}
+
+static uint16_t sgb_encode_altitude(int32_t alt_dm) {
+    int32_t code = (alt_dm / 10 + 400) / 16;
+    if (code < 0) code = 0;
+    if (code >= SGB_RF_ALTITUDE_UNKNOWN) code = SGB_RF_ALTITUDE_UNKNOWN - 1;
+    return (uint16_t)code;
+}
+
+void sgb_cache_init(sgb_cache_t *cache, uint16_t tac, uint16_t serial, uint16_t country) {
+    cache->tac = tac;
+    cache->serial = serial & 0x3FFF;
+    cache->country = country & 0x3FF;
+    cache->valid = 0;
+}
+
+// 250 bits are cheap to rebuild: any change re-encodes the whole frame
+uint8_t sgb_cache_update(sgb_cache_t *cache, uint8_t mode,
+                         int32_t lat, int32_t lon, int32_t alt) {
+    if (cache->valid && cache->mode == mode && cache->latitude == lat &&
+        cache->longitude == lon && cache->altitude == alt) {
+        return 0;
+    }
+    sgb_frame_t *frame = &cache->frame;
+    memset(frame, 0, sizeof(*frame));
+
+    // Main field
+    sgb_set_field(frame, SGB_TAC_START, SGB_TAC_LENGTH, cache->tac);
+    sgb_set_field(frame, SGB_SERIAL_START, SGB_SERIAL_LENGTH, cache->serial);
+    sgb_set_field(frame, SGB_COUNTRY_START, SGB_COUNTRY_LENGTH, cache->country);
+    sgb_set_field(frame, SGB_TEST_PROTOCOL_BIT, 1, mode == BEACON_MODE_TEST);
+    sgb_set_field(frame, SGB_LATITUDE_START, SGB_LATITUDE_LENGTH, sgb_encode_coord(lat, 7));
+    sgb_set_field(frame, SGB_LONGITUDE_START, SGB_LONGITUDE_LENGTH, sgb_encode_coord(lon, 8));
+    sgb_set_field(frame, SGB_BEACON_TYPE_START, SGB_BEACON_TYPE_LENGTH, SGB_BEACON_TYPE_ELT_DT);
+    sgb_set_field(frame, SGB_SPARE_START, SGB_SPARE_LENGTH, SGB_SPARE_NORMAL);
+
+    // Rotating field #0: altitude and fix status, other entries zero
+    sgb_set_field(frame, SGB_ROTATING_START, 4, SGB_RF_G008);
+    sgb_set_field(frame, SGB_RF_ALTITUDE_START, SGB_RF_ALTITUDE_LENGTH, sgb_encode_altitude(alt));
+    sgb_set_field(frame, SGB_RF_GNSS_STATUS_BIT, 2, SGB_GNSS_3D_FIX);
+
+    sgb_set_field(frame, SGB_BCH_START, SGB_BCH_BITS, sgb_compute_bch(frame));
+
+    cache->mode = mode;
+    cache->latitude = lat;
+    cache->longitude = lon;
+    cache->altitude = alt;
+    cache->valid = 1;
+    return 1;
+}
+
+// =============================
+// PRN and chip rendering
+// =============================
+uint16_t sgb_prn_next(uint32_t *state) {
+    uint32_t s = *state;
+    uint16_t lo = (uint16_t)s;
+    uint16_t hi = (uint16_t)(s >> 16);
+    uint16_t fb = sgb_prn_nibble_table[0][lo & 0x0F] ^ sgb_prn_nibble_table[1][(lo >> 4) & 0x0F] ^
+                  sgb_prn_nibble_table[2][(lo >> 8) & 0x0F] ^ sgb_prn_nibble_table[3][lo >> 12] ^
+                  sgb_prn_nibble_table[4][hi & 0x0F] ^ sgb_prn_nibble_table[5][(hi >> 4) & 0x07];
+    *state = (((uint32_t)lo << 16) | fb) & SGB_PRN_MASK;
+    return (uint16_t)(s >> 7);
+}
+
+// Levels and idle codes are set by the caller before the first render
+void sgb_mod_init(sgb_modulator_t *m, const sgb_frame_t *frame) {
+    m->frame = frame;
+    m->prn_i = SGB_PRN_SEED_I;
+    m->prn_q = SGB_PRN_SEED_I;
+    for (uint8_t i = 0; i < SGB_PRN_Q_OFFSET_CHIPS / 16; i++) {
+        sgb_prn_next(&m->prn_q);
+    }
+    m->chip = 0;
+    m->q_prev = m->idle_q;
+}
+
+// Transmitted bits alternate I, Q, I... Chip j: I holds samples 2j and
+// 2j+1, Q changes half a chip later (samples 2j+1 and 2j+2). After the
+// last chip the output returns to the idle level.
+void sgb_mod_render(sgb_modulator_t *m, uint16_t *i_dst, uint16_t *q_dst, uint16_t samples) {
+    for (uint16_t n = 0; n < samples; n += 32) {
+        if (m->chip >= SGB_CHIPS_PER_CHANNEL) {
+            for (uint8_t k = 0; k < 32; k++) {
+                *i_dst++ = m->idle_i;
+                *q_dst++ = m->q_prev;
+                m->q_prev = m->idle_q;
+            }
+            continue;
+        }
+        uint16_t bit = (uint16_t)(2 * (m->chip / SGB_CHIPS_PER_BIT));
+        uint16_t ci = sgb_prn_next(&m->prn_i) ^ (SGB_TX_BIT(*m->frame, bit) ? 0xFFFF : 0);
+        uint16_t cq = sgb_prn_next(&m->prn_q) ^ (SGB_TX_BIT(*m->frame, bit + 1) ? 0xFFFF : 0);
+
+        for (uint8_t k = 0; k < 16; k++) {
+            uint16_t iv = m->level_i[ci >> 15];
+            uint16_t qv = m->level_q[cq >> 15];
+            ci <<= 1;
+            cq <<= 1;
+            *i_dst++ = iv;
+            *i_dst++ = iv;
+            *q_dst++ = m->q_prev;
+            *q_dst++ = qv;
+            m->q_prev = qv;
+        }
+        m->chip += 16;
+    }
+}
@@ -0,0 +1,124 @@
+/* sgb_frame.h - Second-generation (C/S T.018) frame, BCH(250,202) and DSSS chips */
+#ifndef SGB_FRAME_H
+#define SGB_FRAME_H
+
+#include "system_definitions.h"
+
+// =============================
+// Signal (C/S T.018)
+// =============================
+#define SGB_CHIP_RATE_HZ        38400UL     // Per channel, I and Q
+#define SGB_CHIPS_PER_BIT       256         // 150 bit/s per channel, 300 bit/s total
+#define SGB_PREAMBLE_BITS       50          // All zero, spread like the message
+#define SGB_MESSAGE_BITS        250         // 202 information + 48 BCH
+#define SGB_INFO_BITS           202
+#define SGB_BCH_BITS            48
+#define SGB_TX_BITS             (SGB_PREAMBLE_BITS + SGB_MESSAGE_BITS)              // 300, alternately I and Q
+#define SGB_CHIPS_PER_CHANNEL   ((uint32_t)SGB_TX_BITS / 2 * SGB_CHIPS_PER_BIT)      // 38400
+#define SGB_TX_DURATION_MS      (SGB_CHIPS_PER_CHANNEL * 1000UL / SGB_CHIP_RATE_HZ) // 1000
+#define SGB_FRAME_WORDS         16          // 250 bits packed, bit 1 = MSB of w[0]
+
+// BCH(255,207) t = 6 shortened to (250,202), roots alpha^1..alpha^12 in
+// GF(2^8) / x^8+x^4+x^3+x^2+1
+#define SGB_BCH_POLY            0x1C7EB85DF3C97ULL  // g(x), degree 48
+#define SGB_BCH_T               6
+
+// PRN: 23-bit LFSR x^23 + x^18 + 1. Register bit 22 is the next chip out.
+#define SGB_PRN_SEED_I          0x400000UL  // Normal mode 000...001, its 1 is chip 0
+#define SGB_PRN_Q_OFFSET_CHIPS  64          // Q = I sequence advanced 64 chips
+#define SGB_PRN_MASK            0x7FFFFFUL
+
+// =============================
+// Main field (bit numbers 1-202)
+// =============================
+#define SGB_TAC_START           1           // Type approval certificate
+#define SGB_TAC_LENGTH          16
+#define SGB_SERIAL_START        17
+#define SGB_SERIAL_LENGTH       14
+#define SGB_COUNTRY_START       31
+#define SGB_COUNTRY_LENGTH      10
+#define SGB_HOMING_BIT          41
+#define SGB_RLS_BIT             42
+#define SGB_TEST_PROTOCOL_BIT   43          // 1 = test protocol (TEST mode)
+#define SGB_LATITUDE_START      44          // N/S flag, 7 bits degrees, 15 bits 1/32768 deg
+#define SGB_LATITUDE_LENGTH     23
+#define SGB_LONGITUDE_START     67          // E/W flag, 8 bits degrees, 15 bits 1/32768 deg
+#define SGB_LONGITUDE_LENGTH    24
+#define SGB_VESSEL_TYPE_START   91
+#define SGB_VESSEL_TYPE_LENGTH  3
+#define SGB_VESSEL_ID_START     94
+#define SGB_VESSEL_ID_LENGTH    44
+#define SGB_BEACON_TYPE_START   138
+#define SGB_BEACON_TYPE_LENGTH  3
+#define SGB_SPARE_START         141
+#define SGB_SPARE_LENGTH        14
+#define SGB_ROTATING_START      155         // 4-bit identifier + 44 bits
+#define SGB_ROTATING_LENGTH     48
+#define SGB_BCH_START           203
+
+#define SGB_BEACON_TYPE_ELT_DT  0x3
+#define SGB_SPARE_NORMAL        0x3FFF      // All 1s outside a cancellation message
+#define SGB_TAC_TRAINING        9999        // Training generator, not a type-approved unit
+
+// Rotating field #0 (C/S G.008 objective requirements), offsets in bits
+#define SGB_RF_G008             0x0
+#define SGB_RF_ALTITUDE_START   176         // 16 m steps from -400 m, 0x3FF = unknown
+#define SGB_RF_ALTITUDE_LENGTH  10
+#define SGB_RF_ALTITUDE_UNKNOWN 0x3FF
+#define SGB_RF_GNSS_STATUS_BIT  199         // 2 bits: 00 no fix, 01 2D, 10 3D
+#define SGB_GNSS_3D_FIX         0x2
+
+// =============================
+// Data Structures
+// =============================
+typedef struct {
+    uint16_t w[SGB_FRAME_WORDS];
+} sgb_frame_t;
+
+// Cached frame, re-encoded only when mode or position change
+typedef struct {
+    sgb_frame_t frame;              // Complete frame, BCH up to date
+    uint16_t tac;
+    uint16_t serial;                // 14-bit serial number
+    uint16_t country;               // 10-bit country code
+    int32_t latitude;               // Inputs of the last encode (1e-4 min, dm)
+    int32_t longitude;
+    int32_t altitude;
+    uint8_t mode;                   // beacon_mode the frame was built for
+    uint8_t valid;                  // 0 = rebuild
+} sgb_cache_t;
+
+// Chip renderer: both channels, one half-chip per output sample
+typedef struct {
+    const sgb_frame_t *frame;
+    uint32_t prn_i;                 // LFSR registers
+    uint32_t prn_q;
+    uint16_t chip;                  // Chips rendered per channel
+    uint16_t q_prev;                // Q level of the previous chip (half-chip offset)
+    uint16_t level_i[2];            // Output code for chip 0 (+1) and chip 1 (-1)
+    uint16_t level_q[2];
+    uint16_t idle_i;                // Unmodulated level (bias)
+    uint16_t idle_q;
+} sgb_modulator_t;
+
+// Transmitted bit n (0-299): preamble zeros, then frame index n - 50
+#define SGB_TX_BIT(f, n)    ((n) < SGB_PREAMBLE_BITS ? 0 : FRAME_BIT(f, (n) - SGB_PREAMBLE_BITS))
+
+// PRN step table (program memory): 16 new chips per register nibble
+extern const uint16_t sgb_prn_nibble_table[6][16];
+extern const uint64_t sgb_bch_nibble_table[16];
+
+// =============================
+// Prototypes
+// =============================
+void sgb_cache_init(sgb_cache_t *cache, uint16_t tac, uint16_t serial, uint16_t country);
+uint8_t sgb_cache_update(sgb_cache_t *cache, uint8_t mode,
+                         int32_t lat, int32_t lon, int32_t alt);   // 1 = re-encoded
+uint64_t sgb_compute_bch(const sgb_frame_t *frame);    // Parity of bits 1-202
+uint8_t sgb_frame_check_bch(const sgb_frame_t *frame); // 1 = BCH matches
+uint16_t sgb_prn_next(uint32_t *state);                 // Next 16 chips, first chip in bit 15
+void sgb_mod_init(sgb_modulator_t *m, const sgb_frame_t *frame);
+void sgb_mod_render(sgb_modulator_t *m, uint16_t *i_dst, uint16_t *q_dst,
+                    uint16_t samples);                  // Samples: multiple of 32
+
+#endif /* SGB_FRAME_H */
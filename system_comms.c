@@ -5,22 +5,31 @@
 #include "system_debug.h"
 #include "protocol_data.h"
 #include "rf_interface.h"
+#include "system_perf.h"
+#include "tx_impairments.h"
+#include "tx_oqpsk.h"
+#include "tx_telemetry.h"
 
 // =============================
 // Global Variables
 // =============================
 volatile uint32_t millis_counter = 0;              // System time in milliseconds
 volatile uint32_t last_tx_time = 0;                // Timestamp of last transmission
-volatile uint32_t tx_interval_ms = 5000;           // Transmission interval (5s default)
 volatile uint8_t carrier_phase = 0;                // Current carrier phase position
 volatile uint32_t phase_sample_count = 0;           // Phase sample counter
 volatile uint16_t bit_index = 0;                   // Current bit position in frame
 volatile tx_phase_t tx_phase = IDLE_STATE;          // Current transmission state
-volatile uint8_t beacon_frame[MESSAGE_BITS] = {0};  // Transmission frame buffer
+volatile packed_frame_t beacon_frames[2] = {{{0}}}; // Transmission frame buffers (2 x 18 bytes)
+volatile uint8_t tx_active_slot = 0;                // Slot on air (ISR-owned)
+volatile uint8_t tx_ready_slot = 0;                 // Slot published by main
 volatile uint8_t transmission_complete_flag = 0;    // Transmission completion flag
+volatile uint8_t dma_playback_active = 0;           // DMA0 streaming the modulated section
+volatile uint32_t tx_onair_start_ms = 0;            // Burst telemetry stamps (millis_counter)
+volatile uint32_t tx_onair_end_ms = 0;
+volatile uint16_t tx_isr_overruns = 0;              // ISR still running at the next period match
 
 // RF envelope control
-volatile float envelope_gain = 0.0f;               // RF envelope gain (0.0-1.0)
+volatile uint16_t envelope_step = 0;               // RF envelope step (0..ramp_samples)
 volatile uint16_t ramp_samples = RAMP_SAMPLES_DEFAULT;  // RF ramp duration in samples
 volatile uint16_t current_ramp_count = 0;          // Current position in ramp
 
@@ -40,6 +49,39 @@ const uint16_t q_channel_plus_1_1_rad = 2048 + 1823;   // +1.1 rad: sin(1.1) * 2
 const uint16_t q_channel_minus_1_1_rad = 2048 - 1823;  // -1.1 rad: sin(-1.1) * 2047 ≈ -1823
 const uint16_t i_channel_constant = 2048;              // Constant level for reference
 
+// Q channel DAC codes precomputed by init_q_channel_table() (no float math in ISR)
+uint16_t q_channel_dac_table[2][RAMP_SAMPLES_MAX + 1];
+static float q_phase_rad = PHASE_SHIFT_RADIANS;    // Deviation in the tables (IMP PHASE)
+static uint8_t symbol_samples = OVERSAMPLING;      // Length of the current data symbol
+
+#if IQ_DRIVE
+// I channel PWM duties, rebuilt with the Q tables (cos is even: one entry for both signs)
+uint16_t i_channel_pwm_table[2][RAMP_SAMPLES_MAX + 1];
+#endif
+
+#if TRANSITION_SHAPING
+// Raised-cosine phase edges: [sign after the edge][sample since the edge]
+uint16_t q_transition_table[2][TRANSITION_SAMPLES];
+#if IQ_DRIVE
+uint16_t i_transition_table[TRANSITION_SAMPLES];
+#endif
+#define Q_SIGN_NONE 0xFF                          // No edge before the first data sample
+static uint8_t q_last_sign = Q_SIGN_NONE;         // Sign of the previous data sample
+static uint8_t q_trans_pos = TRANSITION_SAMPLES;  // Position in the current edge
+#endif
+
+#if TX_DMA_PLAYBACK
+// DMA ping-pong sample buffer and render/playback cursors
+static uint16_t dma_sample_buf[2 * DMA_HALF_SAMPLES];
+static uint32_t dma_render_index = 0;              // Next burst sample to render
+static volatile uint32_t dma_played_index = 0;     // Burst samples already played
+static volatile const packed_frame_t *dma_frame = beacon_frames;  // Frame being rendered
+static uint16_t dma_bit;                            // Data bit being rendered
+static uint8_t dma_bit_sample;                      // Sample within that symbol
+static uint8_t dma_symbol_len;                      // IMP JITTER: OVERSAMPLING +/-1
+static uint32_t dma_burst_samples = DMA_BURST_SAMPLES;  // Shifted by the jittered symbols
+#endif
+
 void system_halt(const char* message) {
     while(1) {
         DEBUG_LOG_FLUSH(message);
@@ -144,6 +186,30 @@ void init_dac(void) {
     DEBUG_LOG_FLUSH("DAC initialized\r\n");
 }
 
+// =============================
+// I-channel PWM-DAC (PWM1H)
+// =============================
+void init_pwm_i_channel(void) {
+    PCLKCON = 0;                    // PWM master clock: FOSC (100 MHz), no divider
+    PG1CONL = 0;
+    PG1CONLbits.CLKSEL = 1;         // Clock selected by PCLKCON.MCLKSEL
+    PG1CONLbits.MODSEL = 0;         // Independent edge
+    PG1CONH = 0;                    // Own period, update at start of cycle
+    PG1IOCONH = 0;
+    PG1IOCONHbits.PENH = 1;         // PWM1H on RB14 only
+    PG1EVTLbits.UPDTRG = 1;         // Writing PG1DC requests the update (DMA writes)
+    TRISBbits.TRISB14 = 0;
+    
+    PG1PER = PWM_I_PERIOD;
+    PG1PHASE = 0;
+    PG1DC = PWM_I_IDLE_DUTY;        // 500 mV, as the fixed I bias
+    PG1CONLbits.ON = 1;
+    
+    DEBUG_LOG_FLUSH("PWM1H: I channel, ");
+    debug_print_uint32(FOSC / (PWM_I_PERIOD + 1));
+    DEBUG_LOG_FLUSH("Hz\r\n");
+}
+
 // =============================
 // Timer1 Initialization
 // =============================
@@ -151,8 +217,8 @@ void init_timer1(void) {
     T1CON = 0;        // Clear configuration
     TMR1 = 0;         // Reset timer counter
     
-    // Calculate period for 6400 Hz sample rate
-    PR1 = (FCY / ACTUAL_SAMPLE_RATE_HZ) - 1;  // 100MHz/6.4kHz-1 = 15624
+    // Sample rate period (system_config.h)
+    PR1 = TIMER1_PR1;       // 50MHz/12.8kHz-1 = 3905 @32x
     
     // Timer configuration
     T1CONbits.TCKPS = 0;    // No prescaler (1:1)
@@ -166,44 +232,328 @@ void init_timer1(void) {
     debug_print_uint16(PR1);
     DEBUG_LOG_FLUSH(", Freq=");
     debug_print_uint32(FCY/(PR1+1));
-    DEBUG_LOG_FLUSH("Hz (expected 6400Hz)\r\n");
+    DEBUG_LOG_FLUSH("Hz (expected ");
+    debug_print_uint32(SAMPLE_RATE_HZ);
+    DEBUG_LOG_FLUSH("Hz)\r\n");
+}
+
+// Idle between bursts: the timebase runs on SCCP1, Timer1 can stop
+void timer1_park(void) {
+    T1CONbits.TON = 0;
+    IFS0bits.T1IF = 0;
+}
+
+void timer1_unpark(void) {
+    TMR1 = 0;
+    IFS0bits.T1IF = 0;
+    T1CONbits.TON = 1;
+}
+
+// =============================
+// Millisecond Timebase (SCCP1)
+// =============================
+void init_timebase(void) {
+    CCP1CON1L = 0;              // Timer mode (CCSEL=0, MOD=0000), Tcy clock, 1:1
+    CCP1CON1H = 0;
+    CCP1CON2L = 0;
+    CCP1CON2H = 0;
+    CCP1TMRL = 0;
+    CCP1PRL = TIMEBASE_PERIOD;  // FCY / 1000 - 1
+    
+    IPC1bits.CCT1IP = 7;        // Same level as Timer1: no torn 32-bit updates
+    IFS0bits.CCT1IF = 0;
+    IEC0bits.CCT1IE = 1;
+    CCP1CON1Lbits.CCPON = 1;
+    
+    DEBUG_LOG_FLUSH("Timebase: SCCP1 1 kHz\r\n");
+}
+
+void __attribute__((interrupt, auto_psv)) _CCT1Interrupt(void) {
+    millis_counter++;
+    IFS0bits.CCT1IF = 0;
+}
+
+// Lock-free read: retry if the tick landed between the two 16-bit halves
+uint32_t timebase_millis(void) {
+    uint32_t a, b;
+    do {
+        a = millis_counter;
+        b = millis_counter;
+    } while (a != b);
+    return a;
+}
+
+// =============================
+// DMA Burst Playback
+// =============================
+#if TX_DMA_PLAYBACK
+void init_dma_playback(void) {
+    DMACONbits.DMAEN = 1;
+    DMACONbits.PRSSEL = 0;          // Fixed priority
+    DMAL = 0x0000;                  // Full data space
+    DMAH = 0xFFFF;
+    
+    DMA0CH = 0;
+    DMA0CHbits.SIZE = 0;            // Word transfers
+    DMA0CHbits.TRMODE = 3;          // Repeated continuous (ping-pong)
+    DMA0CHbits.SAMODE = 1;          // Source increments
+    DMA0CHbits.DAMODE = 0;          // Destination fixed (DAC1DATH)
+    DMA0CHbits.RELOAD = 1;          // Reload SRC/CNT after each pass
+    DMA0INTbits.CHSEL = DMA_TRIGGER_TMR1;
+    DMA0INTbits.HALFEN = 1;         // Interrupt at half and at end
+    
+    DMA0SRC = (uint16_t)dma_sample_buf;
+    DMA0DST = (uint16_t)&DAC1DATH;
+    DMA0CNT = 2 * DMA_HALF_SAMPLES;
+    
+    IPC2bits.DMA0IP = 5;            // Below Timer1, above UART
+    IFS0bits.DMA0IF = 0;
+    IEC0bits.DMA0IE = 1;
+    
+    DEBUG_LOG_FLUSH("DMA0 playback ready\r\n");
+}
+
+// Render the next samples of the burst (preamble, Biphase-L data, postamble).
+// Symbols are counted as in the ISR, so IMP JITTER lengths apply here too.
+static void dma_render_half(uint16_t *dst) {
+    for (uint16_t i = 0; i < DMA_HALF_SAMPLES; i++) {
+        uint32_t n = dma_render_index++;
+        
+        if (n < PREAMBLE_SAMPLES) {
+            dst[i] = ADL5375_BIAS_DAC_CODE;
+            continue;
+        }
+        if (dma_bit < MESSAGE_BITS) {
+            uint16_t bit = dma_bit;
+            uint16_t s = dma_bit_sample;
+            uint8_t current_bit = FRAME_BIT(*dma_frame, bit) ^ IMPAIR_BIT(bit);
+            uint8_t second_half = (s >= OVERSAMPLING/2);
+            uint8_t q_sign = current_bit ^ second_half;
+            dst[i] = q_channel_dac_table[q_sign][ramp_samples];
+#if TRANSITION_SHAPING
+            // Edges: always at mid-bit, at the bit start when the bit repeats
+            uint16_t pos = second_half ? (uint16_t)(s - OVERSAMPLING/2) : s;
+            if (pos < TRANSITION_SAMPLES &&
+                (second_half || (bit > 0 && (FRAME_BIT(*dma_frame, bit - 1) ^ IMPAIR_BIT(bit - 1)) == current_bit))) {
+                dst[i] = q_transition_table[q_sign][pos];
+            }
+#endif
+            if (++dma_bit_sample >= dma_symbol_len) {
+                dma_bit_sample = 0;
+                if (++dma_bit < MESSAGE_BITS) dma_symbol_len = IMPAIR_SYMBOL_SAMPLES(dma_bit);
+            }
+        } else {
+            dst[i] = DAC_OFFSET;   // Postamble and padding
+        }
+    }
+}
+
+// Pre-render both halves before the ramp-up (main context, DMA idle)
+static void dma_playback_prepare(void) {
+    dma_frame = &beacon_frames[tx_ready_slot];   // Slot the ISR latches at ramp-up
+    dma_render_index = 0;
+    dma_played_index = 0;
+    dma_bit = 0;
+    dma_bit_sample = 0;
+    dma_symbol_len = IMPAIR_SYMBOL_SAMPLES(0);
+    dma_burst_samples = PREAMBLE_SAMPLES + POSTAMBLE_SAMPLES;  // Postamble kept whole
+    for (uint16_t b = 0; b < MESSAGE_BITS; b++) {
+        dma_burst_samples += IMPAIR_SYMBOL_SAMPLES(b);
+    }
+    dma_render_half(&dma_sample_buf[0]);
+    dma_render_half(&dma_sample_buf[DMA_HALF_SAMPLES]);
+    DMA0SRC = (uint16_t)dma_sample_buf;
+    DMA0CNT = 2 * DMA_HALF_SAMPLES;
 }
 
+// Called from _T1Interrupt at the end of PRE_AMPLI_RAMP_UP
+static inline void dma_playback_start(void) {
+    dma_playback_active = 1;
+    DMA0INTbits.HALFIF = 0;
+    DMA0INTbits.DONEIF = 0;
+    DMA0CHbits.CHEN = 1;            // First transfer on next Timer1 trigger
+}
+
+void __attribute__((interrupt, auto_psv)) _DMA0Interrupt(void) {
+    // Half interrupt: first half played; done interrupt: second half played
+    uint16_t *half = DMA0INTbits.HALFIF ? &dma_sample_buf[0] : &dma_sample_buf[DMA_HALF_SAMPLES];
+    DMA0INTbits.HALFIF = 0;
+    DMA0INTbits.DONEIF = 0;
+    
+    dma_played_index += DMA_HALF_SAMPLES;
+    
+    if (dma_played_index >= dma_burst_samples) {
+        // Burst complete: hand back to Timer1 for the ramp-down
+        DMA0CHbits.CHEN = 0;
+        dma_playback_active = 0;
+        DAC1DATH = DAC_OFFSET;
+        current_ramp_count = 0;
+        sample_count = 0;
+        tx_phase = POST_AMPLI_RAMP_DOWN;
+    } else {
+        // Track playback position for status/logging
+        uint32_t n = dma_played_index;
+        if (n < PREAMBLE_SAMPLES) {
+            tx_phase = PREAMBLE_PHASE;
+        } else if (n < PREAMBLE_SAMPLES + MESSAGE_SAMPLES) {
+            bit_index = (uint16_t)((n - PREAMBLE_SAMPLES) / OVERSAMPLING);
+            tx_phase = DATA_PHASE;
+        } else {
+            bit_index = MESSAGE_BITS;
+            tx_phase = POSTAMBLE_PHASE;
+        }
+        dma_render_half(half);
+    }
+    
+    IFS0bits.DMA0IF = 0;
+}
+#endif
+
+// =============================
+// PA Envelope Capture (ADC core 0)
+// =============================
+#if RAMP_MEASUREMENT
+#define RAMP_CAP_UP   0
+#define RAMP_CAP_DOWN 1
+#define RAMP_CAP_OFF  0xFF
+
+static uint16_t ramp_capture[2][RAMP_CAPTURE_LEN];   // [direction][sample since ramp start]
+static uint8_t ramp_capture_len[2];
+static uint8_t ramp_cap_dir = RAMP_CAP_OFF;
+static uint8_t ramp_cap_idx = 0;
+static uint8_t ramp_cap_end = 0;
+static volatile uint8_t ramp_capture_ready = 0;       // Bit per direction, cleared by main
+
+void init_envelope_adc(void) {
+    ANSELAbits.ANSELA0 = 1;         // RA0/AN0: detector input
+    TRISAbits.TRISA0 = 1;
+    
+    ADCON1L = 0;
+    ADCON1H = 0;
+    ADCON2L = 0;
+    ADCON2H = 0;
+    ADCON3L = 0;
+    ADCON3H = 0;
+    ADCON1Hbits.FORM = 0;           // Integer, right aligned
+    ADCON3Hbits.CLKSEL = 0;         // FP (FOSC/2) clock
+    ADCON3Hbits.CLKDIV = 0;
+    ADCORE0Lbits.SAMC = 8;          // 10 TAD sampling
+    ADCORE0Hbits.RES = 3;           // 12-bit
+    ADCORE0Hbits.ADCS = 2;          // TAD = 4 source clocks
+    ADTRIG0Lbits.TRGSRC0 = 1;       // Common software trigger
+    
+    ADCON5Hbits.WARMTIME = 15;
+    ADCON1Lbits.ADON = 1;
+    ADCON5Lbits.C0PWR = 1;
+    while (!ADCON5Lbits.C0RDY);
+    ADCON3Hbits.C0EN = 1;
+    
+    DEBUG_LOG_FLUSH("Envelope ADC: AN0 ready\r\n");
+}
+
+// Start a capture at the first ramp sample (Timer1 ISR)
+static inline void ramp_capture_start(uint8_t dir) {
+    ramp_cap_dir = dir;
+    ramp_cap_idx = 0;
+    ramp_cap_end = (uint8_t)(ramp_samples + RAMP_CAPTURE_TAIL);
+    ADCON3Lbits.SWCTRG = 1;
+}
+
+// One conversion per tick: store the previous one, trigger the next
+static inline void ramp_capture_tick(void) {
+    if (ramp_cap_dir == RAMP_CAP_OFF || !ADSTATLbits.AN0RDY) return;
+    
+    ramp_capture[ramp_cap_dir][ramp_cap_idx++] = ADCBUF0;
+    if (ramp_cap_idx >= ramp_cap_end) {
+        ramp_capture_len[ramp_cap_dir] = ramp_cap_idx;
+        ramp_capture_ready |= (uint8_t)(1 << ramp_cap_dir);
+        ramp_cap_dir = RAMP_CAP_OFF;
+    } else {
+        ADCON3Lbits.SWCTRG = 1;
+    }
+}
+#endif
+
+// =============================
+// Waveform Capture (RLE, one burst)
+// =============================
+#if WAVE_CAPTURE
+_Static_assert(!TX_DMA_PLAYBACK, "WAVE_CAPTURE records Timer1 DAC writes only (TX_DMA_PLAYBACK=0)");
+
+static uint16_t wave_buf[WAVE_CAPTURE_WORDS];
+static uint16_t wave_len = 0;
+static uint16_t wave_lost = 0;                     // Samples dropped, buffer full
+static volatile wave_state_t wave_state = WAVE_IDLE;
+
+void wave_capture_arm(void) {
+    if (wave_state == WAVE_RECORDING) return;
+    wave_len = 0;
+    wave_lost = 0;
+    wave_state = WAVE_ARMED;
+}
+
+wave_state_t wave_capture_state(void) {
+    return wave_state;
+}
+
+const uint16_t *wave_capture_get(uint16_t *words, uint16_t *lost) {
+    if (wave_state != WAVE_DONE) return NULL;
+    *words = wave_len;
+    *lost = wave_lost;
+    return wave_buf;
+}
+
+void wave_capture_release(void) {
+    if (wave_state == WAVE_DONE) wave_state = WAVE_IDLE;
+}
+
+// Timer1 ISR: extend the current run in place, else open a new word
+static inline void wave_capture_put(uint16_t code) {
+    if (wave_len) {
+        uint16_t *w = &wave_buf[wave_len - 1];
+        if ((*w & WAVE_CODE_MASK) == code && (*w >> WAVE_RUN_SHIFT) < WAVE_RUN_MAX - 1) {
+            *w += 1u << WAVE_RUN_SHIFT;
+            return;
+        }
+    }
+    if (wave_len < WAVE_CAPTURE_WORDS) {
+        wave_buf[wave_len++] = code;
+    } else {
+        wave_lost++;
+    }
+}
+#else
+void wave_capture_arm(void) {}
+wave_state_t wave_capture_state(void) { return WAVE_IDLE; }
+const uint16_t *wave_capture_get(uint16_t *words, uint16_t *lost) { return NULL; }
+void wave_capture_release(void) {}
+#endif
+
 // =============================
 // Unified ISR for Envelope and Modulation
 // =============================
 void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
     static uint16_t debug_counter = 0;
     static uint8_t pin_state = 0;
+#if PERF_COUNTERS
+    uint32_t perf_t0 = perf_cycles();
+    perf_id_t perf_id = (perf_id_t)(PERF_ISR_IDLE + tx_phase);  // Phase at entry
+#endif
+    uint16_t tmr_entry = TMR1;     // TMR1 wraps before the exit: a period was lost
     // Phase continuity handled in Biphase-L encoding below
     
     // Toggle debug pin (RB0) for timing analysis
     LATBbits.LATB0 = pin_state = !pin_state;
     
-    // Millisecond counter management
-    // Timer1 = 6400 Hz → 1ms = 6.4 échantillons
-    #define MS_PER_INCREMENT 6  // Approximation 6400/6 = 1066 Hz (trop rapide!)
-    // CORRECTION: 6400 Hz / 6.4 = 1000 Hz (1ms exact)
-    static uint16_t sub_ms_counter = 0;
-    static uint8_t fractional_counter = 0;
-    
-    sub_ms_counter++;
-    // Simulation de 6.4 échantillons par ms avec 6 + 0.4 fractionnaire
-    if (sub_ms_counter >= 6) {
-        sub_ms_counter = 0;
-        fractional_counter += 4;  // Accumulation 0.4
-        if (fractional_counter >= 10) {
-            fractional_counter -= 10;
-            // Skip this increment (6.4 au lieu de 6)
-        } else {
-            millis_counter++;
-        }
-    }
+    // millis_counter is kept by _CCT1Interrupt: sample work only here
     
-    // Biphase-L modulation handling
-    if (++modulation_counter >= MODULATION_INTERVAL) {
+    // Biphase-L modulation handling (skipped while DMA0 owns the DAC)
+    if (!dma_playback_active && ++modulation_counter >= MODULATION_INTERVAL) {
         modulation_counter = 0;
         uint16_t dac_value = DAC_OFFSET;
+#if IQ_DRIVE
+        uint16_t pwm_value = PWM_I_IDLE_DUTY;   // I follows the same table index
+#endif
 
         switch(tx_phase) {
             // RF ramp-up phase: no modulation
@@ -219,49 +569,64 @@ void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
             // Unmodulated carrier phase  
             case PREAMBLE_PHASE:
                 // For ADL5375-05: unmodulated = Q at bias level (500mV)
-                dac_value = (uint16_t)((0.5f * (float)DAC_RESOLUTION) / VOLTAGE_REF_3V3);  // 500mV bias level
+                dac_value = ADL5375_BIAS_DAC_CODE;
+#if IQ_DRIVE
+                pwm_value = i_channel_pwm_table[I_TABLE_CARRIER][envelope_step];  // Carrier on I
+#endif
                 
                 // Check if preamble duration completed
                 if (++sample_count >= PREAMBLE_SAMPLES) {
                     sample_count = 0;
+                    symbol_samples = IMPAIR_SYMBOL_SAMPLES(0);
                     tx_phase = DATA_PHASE;
                     // Phase reset for data transmission
+#if TRANSITION_SHAPING
+                    q_last_sign = Q_SIGN_NONE;
+#endif
                 }
                 break;
 
             // Data transmission phase
             case DATA_PHASE:
                 if (bit_index < MESSAGE_BITS) {
-                    uint8_t current_bit = beacon_frame[bit_index];
-                    float phase_shift;
+                    uint8_t current_bit = FRAME_BIT(beacon_frames[tx_active_slot], bit_index) ^
+                                          IMPAIR_BIT(bit_index);
+                    uint8_t second_half = (sample_count >= OVERSAMPLING/2);
                     
                     // Biphase-L encoding: bit 1 = +/-, bit 0 = -/+
-                    if (current_bit == 1) {
-                        phase_shift = (sample_count < OVERSAMPLING/2) ? 
-                            +PHASE_SHIFT_RADIANS : -PHASE_SHIFT_RADIANS;
-                    } else {
-                        phase_shift = (sample_count < OVERSAMPLING/2) ? 
-                            -PHASE_SHIFT_RADIANS : +PHASE_SHIFT_RADIANS;
+                    // Table lookup replaces sinf()/envelope float math
+                    uint8_t q_sign = current_bit ^ second_half;
+                    dac_value = q_channel_dac_table[q_sign][envelope_step];
+#if IQ_DRIVE
+                    pwm_value = i_channel_pwm_table[I_TABLE_DATA][envelope_step];
+#endif
+#if TRANSITION_SHAPING
+                    // Phase edge: play the shaped path instead of a step
+                    if (q_sign != q_last_sign) {
+                        q_trans_pos = (q_last_sign == Q_SIGN_NONE) ? TRANSITION_SAMPLES : 0;
+                        q_last_sign = q_sign;
                     }
+                    if (q_trans_pos < TRANSITION_SAMPLES) {
+#if IQ_DRIVE
+                        pwm_value = i_transition_table[q_trans_pos];
+#endif
+                        dac_value = q_transition_table[q_sign][q_trans_pos++];
+                    }
+#endif
                     
-                    // Phase continuity maintained automatically in I/Q modulation
-                    
-                    // Calculate ADL5375-05 Q channel value with current envelope
-                    dac_value = calculate_adl5375_q_channel(phase_shift, 1);
-                    
-                    // Debug logging (sample every 500 cycles)
-                    static uint16_t log_counter = 0;
-                    if (++log_counter >= 500) {
-                        log_counter = 0;
-                        ISR_LOG_PHASE(sample_count & 0x0F, envelope_gain, dac_value);
-                    } 
-
-                    // End of symbol handling
-                    if (++sample_count >= OVERSAMPLING) {
+                    // Binary trace: one record per symbol (start of bit), with its length
+                    if (sample_count == 0) {
+                        ISR_TRACE(symbol_samples, envelope_step, dac_value);
+                    }
+
+                    // End of symbol handling (IMP JITTER: +/-1 sample)
+                    if (++sample_count >= symbol_samples) {
                         sample_count = 0;
                         bit_index++;
                         if (bit_index >= MESSAGE_BITS) {
                             tx_phase = POSTAMBLE_PHASE;
+                        } else {
+                            symbol_samples = IMPAIR_SYMBOL_SAMPLES(bit_index);
                         }
                     }
                 }
@@ -282,13 +647,19 @@ void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
                 dac_value = DAC_OFFSET;  // Midpoint voltage
                 if (++debug_counter >= 1000) {
                     debug_counter = 0;
-                    ISR_LOG_PHASE(carrier_phase & 0x0F, envelope_gain, dac_value);
+                    ISR_TRACE(carrier_phase & 0x0F, envelope_step, dac_value);
                 }
                 break;
         }
         
         // Update DAC output register
         DAC1DATH = dac_value & 0x0FFF;
+#if IQ_DRIVE
+        PG1DC = pwm_value;      // Latched at the next PWM cycle (2.56 us), same tick as Q
+#endif
+#if WAVE_CAPTURE
+        if (wave_state == WAVE_RECORDING) wave_capture_put(dac_value & WAVE_CODE_MASK);
+#endif
         
         // Transmission completion detection
         static tx_phase_t previous_phase = IDLE_STATE;
@@ -299,27 +670,57 @@ void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
     }
 
     // RF envelope management (independent of modulation timing)
+#if RAMP_MEASUREMENT
+    ramp_capture_tick();
+#endif
     switch(tx_phase) {
         case PRE_AMPLI_RAMP_UP:
+            if(current_ramp_count == 0) {
+                tx_active_slot = tx_ready_slot;  // Burst boundary: take the published frame
+                if (!rf_chain_ready()) break;    // Hold until the RF sequencer is settled
+                tx_onair_start_ms = millis_counter;  // Same priority as _CCT1Interrupt: no tearing
+#if RAMP_MEASUREMENT
+                ramp_capture_start(RAMP_CAP_UP);
+#endif
+#if WAVE_CAPTURE
+                if (wave_state == WAVE_ARMED) wave_state = WAVE_RECORDING;
+#endif
+            }
             if(current_ramp_count < ramp_samples) {
-                envelope_gain = (float)current_ramp_count / ramp_samples;
+                envelope_step = current_ramp_count;
                 current_ramp_count++;
             } else {
-                envelope_gain = 1.0f;
+                envelope_step = ramp_samples;
                 tx_phase = PREAMBLE_PHASE;
                 sample_count = 0;  // Reset for preamble
+#if SGB_OQPSK
+                if (oqpsk_pending) {
+                    oqpsk_playback_start();     // DMA1-3 own I/Q and PR1 until the ramp-down
+                    break;
+                }
+#endif
+#if TX_DMA_PLAYBACK
+                dma_playback_start();
+#endif
             }
             break;
 
         case POST_AMPLI_RAMP_DOWN:
+#if RAMP_MEASUREMENT
+            if (current_ramp_count == 0) ramp_capture_start(RAMP_CAP_DOWN);
+#endif
             if(current_ramp_count < ramp_samples) {
-                envelope_gain = 1.0f - (float)current_ramp_count / ramp_samples;
+                envelope_step = ramp_samples - current_ramp_count;
                 current_ramp_count++;
             } else {
-                envelope_gain = 0.0f;
-                control_rf_amplifier(0);
+                envelope_step = 0;
+                control_rf_amplifier(0);  // PA off now, rest done by rf_chain_task()
                 LED_TX_PIN = 1;  // Turn off TX LED (inverted logic)
                 tx_phase = IDLE_STATE;
+                tx_onair_end_ms = millis_counter;
+#if WAVE_CAPTURE
+                if (wave_state == WAVE_RECORDING) wave_state = WAVE_DONE;  // Last sample already stored
+#endif
             }
             break;
 
@@ -327,6 +728,11 @@ void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
             break;
     }
 
+#if PERF_COUNTERS
+    perf_record(perf_id, perf_cycles() - perf_t0);
+#endif
+    // OQPSK/DMA start reloads TMR1: not an overrun
+    if (!dma_playback_active && TMR1 < tmr_entry) tx_isr_overruns++;
     // Clear Timer1 interrupt flag
     IFS0bits.T1IF = 0;
 }
@@ -354,32 +760,84 @@ uint16_t adapt_dac_for_adl5375(uint16_t dac_value) {
     return (uint16_t)((voltage * (float)DAC_RESOLUTION) / VOLTAGE_REF_3V3);
 }
 
-// Calculate Q channel value for ADL5375-05 BPSK modulation
-uint16_t calculate_adl5375_q_channel(float phase_shift, uint8_t apply_envelope) {
+// Q channel DAC code for a given phase sign and envelope gain (float, init-time only)
+static uint16_t adl5375_volts_to_code(float q_voltage) {
+    // Clamp to ADL5375-05 range [0, 1V]
+    if (q_voltage < ADL5375_MIN_VOLTAGE) q_voltage = ADL5375_MIN_VOLTAGE;
+    if (q_voltage > ADL5375_MAX_VOLTAGE) q_voltage = ADL5375_MAX_VOLTAGE;
+    
+    // Convert to DAC units (0-4095 for 0-3.3V, scaled to 0-1V range)
+    return (uint16_t)((q_voltage * (float)DAC_RESOLUTION) / VOLTAGE_REF_3V3);
+}
+
+static uint16_t adl5375_q_code(float phase_shift, float gain) {
     // ADL5375-05: 500mV bias ± 500mV swing = 0-1V range
     // Q channel modulation: bias + sin(±1.1 rad) * swing/2
     
     float q_voltage = (float)ADL5375_BIAS_MV / 1000.0f;  // 0.5V bias
     
-    // Add BPSK modulation based on phase shift
-    if (phase_shift >= 0) {
-        q_voltage += (sinf(PHASE_SHIFT_RADIANS) * (float)ADL5375_SWING_MV / 2000.0f);  // +modulation
-    } else {
-        q_voltage += (sinf(-PHASE_SHIFT_RADIANS) * (float)ADL5375_SWING_MV / 2000.0f); // -modulation  
-    }
+    // Add BPSK modulation based on phase shift (+/-PHASE_SHIFT_RADIANS nominal)
+    q_voltage += (sinf(phase_shift) * (float)ADL5375_SWING_MV / 2000.0f);
     
     // Apply envelope gain for RF ramp up/down
-    if (apply_envelope) {
-        float bias_voltage = (float)ADL5375_BIAS_MV / 1000.0f;
-        q_voltage = bias_voltage + (q_voltage - bias_voltage) * envelope_gain;
+    float bias_voltage = (float)ADL5375_BIAS_MV / 1000.0f;
+    q_voltage = bias_voltage + (q_voltage - bias_voltage) * gain;
+    
+    return adl5375_volts_to_code(q_voltage);
+}
+
+#if IQ_DRIVE
+// I channel PWM duty: bias + cos(phi) * swing/2, scaled by the envelope
+static uint16_t adl5375_i_duty(float phase_shift, float gain) {
+    float bias_voltage = (float)ADL5375_BIAS_MV / 1000.0f;
+    float i_voltage = bias_voltage + cosf(phase_shift) * (float)ADL5375_SWING_MV / 2000.0f * gain;
+    return PWM_I_DUTY(adl5375_volts_to_code(i_voltage));
+}
+#endif
+
+// Calculate Q channel value for ADL5375-05 BPSK modulation
+uint16_t calculate_adl5375_q_channel(float phase_shift, uint8_t apply_envelope) {
+    float gain = 1.0f;
+    if (apply_envelope && ramp_samples) {
+        gain = (float)envelope_step / (float)ramp_samples;
     }
+    return adl5375_q_code(phase_shift, gain);
+}
+
+// Precompute Q channel DAC codes for both phase states and every ramp step
+// Must be rebuilt whenever ramp_samples changes
+void init_q_channel_table(void) {
+    uint16_t steps = ramp_samples;
+    if (steps > RAMP_SAMPLES_MAX) steps = RAMP_SAMPLES_MAX;
     
-    // Clamp to ADL5375-05 range [0, 1V]
-    if (q_voltage < ADL5375_MIN_VOLTAGE) q_voltage = ADL5375_MIN_VOLTAGE;
-    if (q_voltage > ADL5375_MAX_VOLTAGE) q_voltage = ADL5375_MAX_VOLTAGE;
+    for (uint16_t i = 0; i <= RAMP_SAMPLES_MAX; i++) {
+        float gain = (i >= steps || steps == 0) ? 1.0f : (float)i / (float)steps;
+        q_channel_dac_table[Q_TABLE_MINUS][i] = adl5375_q_code(-q_phase_rad, gain);
+        q_channel_dac_table[Q_TABLE_PLUS][i]  = adl5375_q_code(+q_phase_rad, gain);
+#if IQ_DRIVE
+        i_channel_pwm_table[I_TABLE_DATA][i]    = adl5375_i_duty(q_phase_rad, gain);
+        i_channel_pwm_table[I_TABLE_CARRIER][i] = adl5375_i_duty(0.0f, gain);
+#endif
+    }
+}
+
+// Precompute the shaped phase edges (full envelope, data phase only)
+// Into +1.1 rad: phi(t) = -1.1 * cos(pi * t), t = (k + 0.5) / TRANSITION_SAMPLES
+void init_q_transition_table(void) {
+#if TRANSITION_SHAPING
+    const float bias_voltage = (float)ADL5375_BIAS_MV / 1000.0f;
+    const float half_swing = (float)ADL5375_SWING_MV / 2000.0f;
     
-    // Convert to DAC units (0-4095 for 0-3.3V, scaled to 0-1V range)
-    return (uint16_t)((q_voltage * (float)DAC_RESOLUTION) / VOLTAGE_REF_3V3);
+    for (uint16_t k = 0; k < TRANSITION_SAMPLES; k++) {
+        float t = ((float)k + 0.5f) / (float)TRANSITION_SAMPLES;
+        float phi = q_phase_rad * cosf(3.14159265f * t);
+        q_transition_table[Q_TABLE_PLUS][k]  = adl5375_volts_to_code(bias_voltage + sinf(-phi) * half_swing);
+        q_transition_table[Q_TABLE_MINUS][k] = adl5375_volts_to_code(bias_voltage + sinf(phi) * half_swing);
+#if IQ_DRIVE
+        i_transition_table[k] = PWM_I_DUTY(adl5375_volts_to_code(bias_voltage + cosf(phi) * half_swing));
+#endif
+    }
+#endif
 }
 
 // Legacy function for backward compatibility
@@ -391,72 +849,188 @@ uint16_t calculate_modulated_value(float phase_shift, uint8_t carrier_phase, uin
 // =============================
 // RF Rise/Fall Time Calibration
 // =============================
+#if RAMP_MEASUREMENT
+// Crossing of 'level' in 1/16 sample units, searched from the start
+static int16_t ramp_crossing_q4(const uint16_t *buf, uint8_t len, int32_t level, uint8_t rising) {
+    for (uint8_t i = 1; i < len; i++) {
+        int32_t a = buf[i - 1];
+        int32_t b = buf[i];
+        if (rising ? (b >= level && a < level) : (b <= level && a > level)) {
+            return (int16_t)(((int32_t)(i - 1) << 4) + ((level - a) << 4) / (b - a));
+        }
+    }
+    return -1;
+}
+
+// 10-90% transition time (Q4 samples) and 90% point from ramp start
+static uint8_t ramp_edge_measure(const uint16_t *buf, uint8_t len, uint8_t rising,
+                                 int16_t *edge_q4, int16_t *settle_q4) {
+    int32_t v0 = buf[0];
+    int32_t v1 = buf[len - 1];              // Tail: settled level
+    int32_t swing = v1 - v0;
+    
+    if ((rising ? swing : -swing) < RAMP_MIN_SWING) return 0;
+    
+    int16_t t10 = ramp_crossing_q4(buf, len, v0 + swing / 10, rising);
+    int16_t t90 = ramp_crossing_q4(buf, len, v0 + (swing * 9) / 10, rising);
+    if (t10 < 0 || t90 < t10) return 0;
+    
+    *edge_q4 = t90 - t10;
+    *settle_q4 = t90;
+    return 1;
+}
+#endif
+
+static uint16_t ramp_rise_us = 0;           // Running averages, 0 until measured
+static uint16_t ramp_fall_us = 0;
+static int16_t ramp_settle_avg_q4 = -1;     // 90% point of the rise (Q4 samples)
+
+#define Q4_SAMPLES_TO_US(q4)  ((uint16_t)(((uint32_t)(q4) * 1000000UL) / (16UL * SAMPLE_RATE_HZ)))
+
+static uint16_t ramp_average(uint16_t avg, uint16_t x) {
+    if (avg == 0) return x;
+    return (uint16_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> RAMP_AVG_SHIFT));
+}
+
+uint16_t ramp_get_rise_us(void) { return ramp_rise_us; }
+uint16_t ramp_get_fall_us(void) { return ramp_fall_us; }
+
+// Between bursts only (tx_phase == IDLE_STATE): consumes the last capture,
+// then moves ramp_samples one step towards the measured settle point
 void calibrate_rise_fall_times(void) {
-    // Placeholder for actual measurement
-    float actual_rise_time = 125.0f;
-    float actual_fall_time = 115.0f; 
+#if RAMP_MEASUREMENT
+    uint8_t ready = ramp_capture_ready;
+    int16_t edge_q4, settle_q4;
+    
+    if (ready & (1 << RAMP_CAP_UP)) {
+        if (ramp_edge_measure(ramp_capture[RAMP_CAP_UP], ramp_capture_len[RAMP_CAP_UP], 1,
+                              &edge_q4, &settle_q4)) {
+            ramp_rise_us = ramp_average(ramp_rise_us, Q4_SAMPLES_TO_US(edge_q4));
+            ramp_settle_avg_q4 = (ramp_settle_avg_q4 < 0) ? settle_q4 :
+                (int16_t)(ramp_settle_avg_q4 + ((settle_q4 - ramp_settle_avg_q4) >> RAMP_AVG_SHIFT));
+        }
+    }
+    if (ready & (1 << RAMP_CAP_DOWN)) {
+        if (ramp_edge_measure(ramp_capture[RAMP_CAP_DOWN], ramp_capture_len[RAMP_CAP_DOWN], 0,
+                              &edge_q4, &settle_q4)) {
+            ramp_fall_us = ramp_average(ramp_fall_us, Q4_SAMPLES_TO_US(edge_q4));
+        }
+    }
+    ramp_capture_ready = 0;
+#endif
+    
+    if (ramp_rise_us == 0 || ramp_fall_us == 0) return;   // Nothing measured yet
     
     // Calculate symmetry
-    float symmetry = fabsf(actual_rise_time - actual_fall_time) / 
-                    fabsf(actual_rise_time + actual_fall_time);
+    float symmetry = fabsf((float)ramp_rise_us - (float)ramp_fall_us) / 
+                    (float)(ramp_rise_us + ramp_fall_us);
     
-    // Symmetry check
-    if (symmetry > SYMMETRY_THRESHOLD) {
+    // Symmetry check (reported once)
+    static uint8_t symmetry_reported = 0;
+    if (symmetry > SYMMETRY_THRESHOLD && !symmetry_reported) {
+        symmetry_reported = 1;
         DEBUG_LOG_FLUSH("Symmetry error: ");
         debug_print_float(symmetry, 3);
         DEBUG_LOG_FLUSH("\r\n");
     }
     
-    // Adjust ramp samples based on timing
-    if (actual_rise_time < RISE_TIME_MIN_US) 
-        ramp_samples = (uint16_t)(ramp_samples * 1.1f);
-    else if (actual_rise_time > RISE_TIME_MAX_US) 
-        ramp_samples = (uint16_t)(ramp_samples * 0.9f);
+    // Ramp long enough to reach 90% plus margin, and no longer
+    uint16_t target = (uint16_t)((ramp_settle_avg_q4 + 15) >> 4) + RAMP_MARGIN_SAMPLES;
+    if (target < 1) target = 1;
+    if (target > RAMP_SAMPLES_MAX) target = RAMP_SAMPLES_MAX;
+    
+    if (target == ramp_samples) return;
+    ramp_samples += (target > ramp_samples) ? 1 : -1;   // One step per burst
+    init_q_channel_table();
     
     DEBUG_LOG_FLUSH("Ramp samples: ");
     debug_print_uint32(ramp_samples);
-    DEBUG_LOG_FLUSH("\r\n");
+    DEBUG_LOG_FLUSH(" (rise ");
+    debug_print_uint16(ramp_rise_us);
+    DEBUG_LOG_FLUSH("us, fall ");
+    debug_print_uint16(ramp_fall_us);
+    DEBUG_LOG_FLUSH("us)\r\n");
 }
 
 // =============================
 // Transmission Start Sequence
 // =============================
-void start_transmission(volatile const uint8_t* data) {
-    static uint8_t first_run = 1;
-    if(first_run) {
-        calibrate_rise_fall_times();
-        first_run = 0;
+static void start_burst_sequence(void);
+
+uint8_t start_transmission(volatile const packed_frame_t* data) {
+    // Burst in progress: the back slot becomes the live one only at the
+    // next ramp-up, flipping now would hand the on-air slot to the builder
+    if (tx_phase != IDLE_STATE) {
+        return 0;
     }
-    
-	last_tx_time = millis_counter;
+	last_tx_time = timebase_millis();
 	
-    // Copy data to frame buffer atomically
-    __builtin_disable_interrupts();
-    for (uint16_t i = 0; i < MESSAGE_BITS; i++) {
-        beacon_frame[i] = data[i];
+    // Publish the frame: the ISR only reads tx_active_slot, so the back
+    // slot can be written with interrupts enabled. Frames built in place
+    // (beacon_frame) need no copy at all.
+    uint8_t slot = tx_ready_slot ^ 1;
+    if (data != &beacon_frames[slot]) {
+        for (uint8_t i = 0; i < FRAME_WORDS; i++) {
+            beacon_frames[slot].w[i] = data->w[i];
+        }
     }
-    __builtin_enable_interrupts();
+    tx_ready_slot = slot;   // Single byte store - picked up at next ramp-up
+    
+    // Ramp adjusted from the previous burst's measurement (ISR idle)
+    calibrate_rise_fall_times();
+    impair_prepare_burst();        // IMP: masks, phase tables, Timer1 period
+#if TX_DMA_PLAYBACK
+    dma_playback_prepare();
+#endif
+    start_burst_sequence();
+    return 1;
+}
+
+#if SGB_OQPSK
+// Second-generation burst: same ramps, OQPSK section played by DMA1-3.
+// The frame is copied and pre-rendered here, so only while idle.
+void start_transmission_sgb(const sgb_frame_t *frame) {
+    if (tx_phase != IDLE_STATE) return;
+    last_tx_time = timebase_millis();
     
+    calibrate_rise_fall_times();
+    impair_prepare_burst();        // Masks unused, Timer1 period of the ramps
+    oqpsk_playback_prepare(frame);
+    start_burst_sequence();
+}
+#endif
+
+// Common part of a burst start (tx idle)
+static void start_burst_sequence(void) {
     // Reset transmission state
     sample_count = 0;
     bit_index = 0;
     current_ramp_count = 0;
-    envelope_gain = 0.0f;
+    envelope_step = 0;
     
-    // Activate RF systems
-    control_rf_amplifier(1);       // Enable RF amplifier
+    // Activate RF systems (sequenced by rf_chain_task, ramp waits for ready)
+    rf_channel_poll_switch();      // RB13 moved: retune now, RF output still off
+    telemetry_burst_begin();       // Counter snapshot, closed by telemetry_task()
+    control_rf_amplifier(1);       // Request RF chain power-up
     LED_TX_PIN = 0;                // Turn on transmission LED
     tx_phase = PRE_AMPLI_RAMP_UP;  // Start transmission sequence
 }
 
 // RF functions moved to rf_interface.c
-//============================
-//
-//============================
-void set_tx_interval(uint32_t interval_ms) {
-    __builtin_disable_interrupts();
-    tx_interval_ms = interval_ms;
-    __builtin_enable_interrupts();
+
+// Phase deviation of the Q tables (nominal PHASE_SHIFT_RADIANS), tx idle only
+void set_phase_deviation(float rad) {
+    if (rad == q_phase_rad) return;
+    q_phase_rad = rad;
+    init_q_channel_table();
+    init_q_transition_table();
+}
+
+// Sample clock offset for the next burst, 0 = nominal TIMER1_PR1
+void timer1_set_rate_offset(int32_t ppm) {
+    uint32_t ticks = (uint32_t)(((uint64_t)TIMER1_PERIOD_TICKS * 1000000ULL + (uint32_t)(1000000L + ppm) / 2) /
+                                (uint32_t)(1000000L + ppm));
+    PR1 = (uint16_t)(ticks - 1);
 }
 
 // =============================
@@ -466,19 +1040,36 @@ void system_init(void) {
     init_clock();              // Configure system clock
     init_gpio();               // Initialize GPIO pins
     init_dac();                // Set up DAC module
+#if SGB_OQPSK || IQ_DRIVE
+    init_pwm_i_channel();      // I arm at its bias until a T.018 or I/Q burst
+#endif
+#if RAMP_MEASUREMENT
+    init_envelope_adc();       // PA detector for ramp calibration
+#endif
     system_debug_init();       // Initialize debug system
     init_comm_uart();          // Set up communication UART
+    init_timebase();           // SCCP1 millisecond tick
     init_timer1();             // Configure sample timer
+    perf_init();               // SCCP2 cycle counters
+#if TX_DMA_PLAYBACK
+    init_dma_playback();       // DMA0 feed for modulated section
+#endif
+#if SGB_OQPSK
+    init_oqpsk_playback();     // DMA1-3 for T.018 bursts
+#endif
     
     // Initialize RF modules (managed by rf_interface.c)
     rf_initialize_all_modules(); // Initialize complete RF chain
     
     // Initialize time management variables
     last_tx_time = 0;
-    //tx_interval_ms = 5000;
     ramp_samples = RAMP_SAMPLES_DEFAULT;
-    envelope_gain = 0.0f;
+    envelope_step = 0;
+    init_q_channel_table();
+    init_q_transition_table();
     
     // Clear frame buffer
-    memset((void*)beacon_frame, 0, MESSAGE_BITS);
+    memset((void*)beacon_frames, 0, sizeof(beacon_frames));
+    tx_active_slot = 0;
+    tx_ready_slot = 0;
 }
@@ -6,31 +6,23 @@
 // =============================
 // ELT Standard Configuration
 // =============================
-#define SYMBOL_RATE_HZ          400     // Mandatory 400 baud symbol rate
-#define OVERSAMPLING            16      // 16 samples per symbol
-#define ACTUAL_SAMPLE_RATE_HZ   (SYMBOL_RATE_HZ * OVERSAMPLING)  // 6400 Hz
-
-// Transmission segment durations (ms)
-#define PREAMBLE_DURATION_MS    160     // Unmodulated carrier
-#define MODULATED_DURATION_MS   360     // Biphase-L modulated data
-#define POSTAMBLE_DURATION_MS   320     // Silence after transmission
+// Symbol rate, oversampling and segment durations: system_config.h
 #define MODULATION_INTERVAL 1
 #define SYMMETRY_THRESHOLD 0.05f
-#define RISE_TIME_MIN_US 50
-#define RISE_TIME_MAX_US 150
 
-// Sample calculations
-#define PREAMBLE_SAMPLES        ((uint32_t)PREAMBLE_DURATION_MS * ACTUAL_SAMPLE_RATE_HZ / 1000)   // 1024
-#define POSTAMBLE_SAMPLES       ((uint32_t)POSTAMBLE_DURATION_MS * ACTUAL_SAMPLE_RATE_HZ / 1000)  // 2048
+// Low-power idle between bursts (Timer1 stopped, CPU in Idle)
+#ifndef LOW_POWER_IDLE
+#define LOW_POWER_IDLE          1
+#endif
+#define POWER_WAKE_MARGIN_MS    2       // Added to the measured wake latency
+#define POWER_PARK_MIN_MS       50      // Do not park for shorter gaps
 
 // Message structure
 #define SYNC_BITS               15      // Synchronization bits
 #define FRAME_SYNC_BITS         9       // Frame synchronization bits
 #define DATA_BITS               120     // Payload data bits (144 - 15 - 9)
-#define MESSAGE_BITS            144     // Total bits (SYNC + FRAME_SYNC + DATA)
 
-// RF Parameters
-#define RAMP_SAMPLES_DEFAULT    10      // ~1.56ms @6400Hz (<2ms required)
+// RF Parameters (ramp length derived in system_config.h)
 #define PHASE_SHIFT_RADIANS     1.1f    // �1.1 rad (C/S T.001 standard)
 
 // =============================
@@ -45,7 +37,6 @@
 // DAC Configuration  
 #define DAC_OFFSET              2048             // 1.65V mid-point
 #define DAC_RESOLUTION          4096             // 12-bit DAC
-#define SAMPLE_FREQ_HZ          6400             // 6.4 kHz sample rate
 
 // ADL5375-05 Interface Configuration
 #define ADL5375_BIAS_MV         500              // 500mV bias level for ADL5375-05
@@ -53,6 +44,78 @@
 #define ADL5375_MIN_VOLTAGE     0.0f             // Minimum voltage (bias - swing/2)
 #define ADL5375_MAX_VOLTAGE     1.0f             // Maximum voltage (bias + swing/2)
 #define VOLTAGE_REF_3V3         3.3f             // dsPIC33CK supply voltage
+#define ADL5375_BIAS_DAC_CODE   ((uint16_t)(((uint32_t)ADL5375_BIAS_MV * DAC_RESOLUTION) / 3300UL))  // 500mV = 620
+
+// I-channel PWM-DAC (T.018 bursts, IQ_DRIVE): PWM1H on RB14 -> RC low-pass -> IBBP.
+// Same 0-3.3 V scale as the DAC, duty = code * (PWM_I_PERIOD + 1) / 4096.
+// PWM1L (RB15) is left to the GPIO: PA enable.
+#define PWM_I_PERIOD            255              // PG1PER: 100 MHz / 256 = 390.6 kHz, 8 bits
+#define PWM_I_DUTY(code)        ((uint16_t)(((uint32_t)(code) * (PWM_I_PERIOD + 1) + DAC_RESOLUTION / 2) / DAC_RESOLUTION))
+#define PWM_I_IDLE_DUTY         PWM_I_DUTY(ADL5375_BIAS_DAC_CODE)   // I at its 500 mV bias
+
+// T.001 true I/Q drive: I = cos(phi) on the PWM-DAC, Q = sin(phi) on the
+// DAC, both written from the same table index in the same Timer1 tick.
+// 0 = legacy Q-only drive, I held at its bias (phase approximated on Q).
+#ifndef IQ_DRIVE
+#define IQ_DRIVE                0
+#endif
+
+// DMA burst playback: preamble + data + postamble streamed into DAC1DATH
+// by DMA0 on the Timer1 trigger. The full burst (BURST_SAMPLES) does not fit
+// in RAM, so it is rendered ahead into a ping-pong buffer refilled from the
+// DMA half/done interrupt.
+#ifndef TX_DMA_PLAYBACK
+#define TX_DMA_PLAYBACK         0                // 1 = DMA-fed DAC for modulated section
+#endif
+#define DMA_HALF_SAMPLES        128              // Samples per half buffer (10 ms @32x, 5 ms @64x)
+#define DMA_TRIGGER_TMR1        0x04             // DMAxINT.CHSEL: Timer1 (DS70005399D DMA trigger table)
+#define DMA_BURST_SAMPLES       BURST_SAMPLES
+#if IQ_DRIVE && TX_DMA_PLAYBACK
+#error "IQ_DRIVE needs the Timer1 ISR path: DMA0 only feeds the DAC (TX_DMA_PLAYBACK=0)"
+#endif
+
+// PA envelope detector on RA0/AN0 (ADC dedicated core 0), sampled once
+// per Timer1 tick across each ramp to measure the real rise/fall times
+#ifndef RAMP_MEASUREMENT
+#define RAMP_MEASUREMENT        1
+#endif
+#define RAMP_CAPTURE_TAIL       8                // Samples kept after the ramp (settled level)
+#define RAMP_CAPTURE_LEN        (RAMP_SAMPLES_MAX + RAMP_CAPTURE_TAIL)
+#define RAMP_MIN_SWING          64               // ADC counts: smaller swing = no detector
+#define RAMP_MARGIN_SAMPLES     1                // Ramp kept this far past the 90% point
+#define RAMP_AVG_SHIFT          2                // Running average weight 1/4
+
+// Waveform capture: every DAC1DATH code written by Timer1 during one armed
+// burst, run-length encoded in place and streamed on UART2 afterwards.
+// Word: bits 15-12 = run length - 1, bits 11-0 = DAC code.
+// Lab build only (-DWAVE_CAPTURE=1): the buffer counts against the 8 KB of
+// RAM, see DEBUG_RAM_BUDGET. The default window holds the ramp-up and the
+// first ~300 ms of the burst @32x; the rest is counted as lost. A whole
+// burst is ~1360 words, which only the host bench can afford.
+#ifndef WAVE_CAPTURE
+#define WAVE_CAPTURE            0
+#endif
+#ifndef WAVE_CAPTURE_WORDS
+#define WAVE_CAPTURE_WORDS      512              // 1 KB
+#endif
+#define WAVE_CODE_MASK          0x0FFF
+#define WAVE_RUN_SHIFT          12
+#define WAVE_RUN_MAX            16               // Samples per word
+
+typedef enum {
+    WAVE_IDLE,              // Not armed
+    WAVE_ARMED,             // Waiting for the next ramp-up
+    WAVE_RECORDING,         // Burst on air
+    WAVE_DONE               // Buffer complete, waiting for the stream
+} wave_state_t;
+
+// Q channel DAC code table: [phase sign][envelope step]
+#define Q_TABLE_MINUS           0                // -1.1 rad
+#define Q_TABLE_PLUS            1                // +1.1 rad
+
+// I channel PWM duty table (IQ_DRIVE): [carrier phase][envelope step]
+#define I_TABLE_DATA            0                // cos(+/-1.1 rad), either sign
+#define I_TABLE_CARRIER         1                // cos(0), unmodulated preamble
 
 // =============================
 // Transmission States
@@ -74,24 +137,44 @@ typedef enum {
 void init_clock(void);       // System clock configuration
 void init_gpio(void);        // GPIO pin initialization
 void init_dac(void);         // DAC module setup
+void init_pwm_i_channel(void); // PWM1H I-channel DAC, idle at the 500 mV bias
 void init_timer1(void);      // Timer1 for sample generation
+void timer1_park(void);      // Stop the sample timer between bursts
+void timer1_unpark(void);    // Restart it at SAMPLE_RATE_HZ
+void init_timebase(void);    // SCCP1 1 kHz millisecond tick
+uint32_t timebase_millis(void);  // Consistent millis_counter read (any context)
+void init_dma_playback(void); // DMA0 Timer1-triggered DAC feed
+void init_envelope_adc(void); // AN0 detector for ramp measurement
 void system_init(void);      // Main system initialization
 
 // RF Control functions - moved to rf_interface.h
 
 // Transmission management
-void calibrate_rise_fall_times(void);    // RF ramp timing calibration
-void start_transmission(volatile const uint8_t* data);  // Start TX sequence
+void calibrate_rise_fall_times(void);    // RF ramp calibration from the last measurement
+uint16_t ramp_get_rise_us(void);         // Averaged 10-90% rise (0 = not measured)
+uint16_t ramp_get_fall_us(void);         // Averaged 90-10% fall (0 = not measured)
+uint8_t start_transmission(volatile const packed_frame_t* data);  // Start TX sequence, 0 = burst in progress
 uint16_t calculate_modulated_value(float phase_shift, uint8_t carrier_phase, uint8_t apply_envelope);  // BPSK modulation
 
 // ADL5375-05 Interface functions
 uint16_t adapt_dac_for_adl5375(uint16_t dac_value);     // Convert DAC levels for ADL5375-05
 uint16_t calculate_adl5375_q_channel(float phase_shift, uint8_t apply_envelope);  // Q channel for ADL5375-05
+void init_q_channel_table(void);                        // Precompute Q DAC codes (and I duties) for ISR
+void init_q_transition_table(void);                     // Precompute shaped phase edges
+
+// Waveform capture (WAVE command)
+void wave_capture_arm(void);                            // Record the next burst
+wave_state_t wave_capture_state(void);
+const uint16_t *wave_capture_get(uint16_t *words, uint16_t *lost);  // WAVE_DONE only
+void wave_capture_release(void);                        // Buffer streamed, back to idle
 
-void set_tx_interval(uint32_t interval_ms); 
+void set_phase_deviation(float rad);     // Rebuild the Q tables for +/-rad
+void timer1_set_rate_offset(int32_t ppm); // Timer1 period for the next burst
 
 // Interrupt Service Routines
 void __attribute__((__interrupt__, __auto_psv__)) _T1Interrupt(void);  // Timer1 ISR
+void __attribute__((__interrupt__, __auto_psv__)) _CCT1Interrupt(void); // 1 ms timebase
+void __attribute__((__interrupt__, __auto_psv__)) _DMA0Interrupt(void); // DMA playback refill
 
 // =============================
 // Shared Global Variables
@@ -99,12 +182,13 @@ void __attribute__((__interrupt__, __auto_psv__)) _T1Interrupt(void);  // Timer1
 extern volatile uint32_t millis_counter;          // System time in milliseconds
 extern volatile tx_phase_t tx_phase;              // Current transmission phase
 extern volatile uint32_t last_tx_time;            // Last transmission timestamp
-extern volatile uint32_t tx_interval_ms;          // Transmission interval
 extern volatile uint8_t carrier_phase;            // Current carrier phase
 extern volatile uint32_t phase_sample_count;      // Phase sample counter
 extern volatile uint16_t bit_index;               // Current bit index in frame
-extern volatile uint8_t beacon_frame[MESSAGE_BITS]; // Transmission frame data
-extern volatile float envelope_gain;              // RF envelope gain (0.0-1.0)
+extern volatile packed_frame_t beacon_frames[2];  // Transmission frames (double buffer)
+extern volatile uint8_t tx_active_slot;           // Slot read by Timer1/DMA0
+extern volatile uint8_t tx_ready_slot;            // Slot handed over for the next burst
+extern volatile uint16_t envelope_step;           // RF envelope step (0..ramp_samples)
 extern volatile uint16_t ramp_samples;            // RF ramp duration in samples
 extern volatile uint16_t current_ramp_count;      // Current ramp position
 extern volatile uint16_t modulation_counter;      // Modulation sample counter
@@ -112,5 +196,19 @@ extern volatile uint16_t sample_count;            // General sample counter
 extern volatile uint8_t amp_enabled;              // RF amplifier state
 extern volatile uint8_t current_power_mode;       // Current power mode
 extern volatile uint8_t transmission_complete_flag; // TX completion flag
+extern volatile uint8_t dma_playback_active;      // DMA0 owns DAC1DATH
+extern volatile uint32_t tx_onair_start_ms;       // Ramp-up start (Timer1 ISR stamp)
+extern volatile uint32_t tx_onair_end_ms;         // Ramp-down end (Timer1 ISR stamp)
+extern volatile uint16_t tx_isr_overruns;         // Timer1 periods lost, since boot
+extern uint16_t q_channel_dac_table[2][RAMP_SAMPLES_MAX + 1]; // Q DAC codes per sign/envelope step
+#if TRANSITION_SHAPING
+extern uint16_t q_transition_table[2][TRANSITION_SAMPLES];    // Shaped edge into each sign
+#endif
+#if IQ_DRIVE
+extern uint16_t i_channel_pwm_table[2][RAMP_SAMPLES_MAX + 1]; // I PWM duties per phase/envelope step
+#if TRANSITION_SHAPING
+extern uint16_t i_transition_table[TRANSITION_SAMPLES];       // cos(phi) along the edge, both signs
+#endif
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef SYSTEM_CONFIG_H
+#define SYSTEM_CONFIG_H
+
+/* system_config.h - Sample-rate configuration
+ * Single source for the modulation timing. Sample counts, the Timer1
+ * period, the ramp length and the table sizes are derived from
+ * OVERSAMPLING and checked below. The default is 32x; a 64x variant
+ * only needs
+ *   -DOVERSAMPLING=64
+ * on the compiler command line. FCY comes from includes.h.
+ */
+
+// =============================
+// Modulation (C/S T.001)
+// =============================
+#define SYMBOL_RATE_HZ          400     // Mandatory 400 baud symbol rate
+#ifndef OVERSAMPLING
+#define OVERSAMPLING            32      // Samples per symbol (32, 64; 16 needs TRANSITION_SHAPING=0)
+#endif
+#define SAMPLE_RATE_HZ          ((uint32_t)SYMBOL_RATE_HZ * OVERSAMPLING)   // 12800 Hz @32x
+#define SAMPLES_PER_SYMBOL      OVERSAMPLING
+#define SAMPLES_PER_HALF_BIT    (OVERSAMPLING / 2)  // Biphase-L mid-bit transition
+
+#define MESSAGE_BITS            144     // Long message (SYNC + FRAME_SYNC + DATA)
+
+// Transmission segment durations (ms)
+#define PREAMBLE_DURATION_MS    160     // Unmodulated carrier
+#define MODULATED_DURATION_MS   360     // Biphase-L modulated data
+#define POSTAMBLE_DURATION_MS   320     // Silence after transmission
+#define TOTAL_TX_DURATION_MS    (PREAMBLE_DURATION_MS + MODULATED_DURATION_MS + POSTAMBLE_DURATION_MS)
+
+// =============================
+// Derived sample counts
+// =============================
+#define PREAMBLE_SAMPLES        ((uint32_t)PREAMBLE_DURATION_MS * SAMPLE_RATE_HZ / 1000)   // 2048 @32x
+#define MESSAGE_SAMPLES         ((uint32_t)MESSAGE_BITS * OVERSAMPLING)                    // 4608 @32x
+#define POSTAMBLE_SAMPLES       ((uint32_t)POSTAMBLE_DURATION_MS * SAMPLE_RATE_HZ / 1000)  // 4096 @32x
+#define BURST_SAMPLES           (PREAMBLE_SAMPLES + MESSAGE_SAMPLES + POSTAMBLE_SAMPLES)   // 10752 @32x
+
+// =============================
+// Timer1 sample clock
+// =============================
+// FCY is not a multiple of 12800: PR1 truncates and the rate error is
+// bounded by SAMPLE_RATE_TOL_PPM instead (64 ppm at 32x and 64x)
+#define TIMER1_PERIOD_TICKS     (FCY / SAMPLE_RATE_HZ)                  // 3906 @32x
+#define TIMER1_PR1              (TIMER1_PERIOD_TICKS - 1)
+#define SAMPLE_RATE_ACTUAL_HZ   (FCY / TIMER1_PERIOD_TICKS)
+#define SAMPLE_RATE_ERR_PPM     ((((unsigned long long)FCY - (unsigned long long)TIMER1_PERIOD_TICKS * SAMPLE_RATE_HZ) * 1000000ULL) / \
+                                 ((unsigned long long)TIMER1_PERIOD_TICKS * SAMPLE_RATE_HZ))
+#define SAMPLE_RATE_TOL_PPM     100     // Well inside the 400 bps tolerance
+
+// Millisecond timebase (SCCP1, independent of the sample timer)
+#define TIMEBASE_HZ             1000
+#define TIMEBASE_PERIOD         ((FCY / TIMEBASE_HZ) - 1)   // 49999 @ FCY 50 MHz
+
+// =============================
+// RF envelope ramp
+// =============================
+#define RAMP_DURATION_US        1560    // Default ramp (<2 ms required)
+#define RAMP_MAX_US             5000    // Calibration upper bound
+#define US_TO_SAMPLES(us)       (((uint32_t)(us) * SAMPLE_RATE_HZ + 500000UL) / 1000000UL)
+#define RAMP_SAMPLES_DEFAULT    US_TO_SAMPLES(RAMP_DURATION_US)   // 20 @32x
+#define RAMP_SAMPLES_MAX        US_TO_SAMPLES(RAMP_MAX_US)        // 64 @32x (Q table size)
+
+// =============================
+// Biphase-L phase transitions
+// =============================
+// Raised-cosine phase path between -1.1 and +1.1 rad, played from a table
+// over the first TRANSITION_SAMPLES samples after each edge. The DAC holds
+// each sample (ZOH): the phase crosses 10% / 90% at the step of the first
+// table entry past that level, p_k = (1 - cos(pi (k + 0.5) / N)) / 2, and
+// k = N is the final level. The rise is a whole number of sample periods.
+#ifndef TRANSITION_SHAPING
+#define TRANSITION_SHAPING      1
+#endif
+#define RISE_TIME_MIN_US        50      // C/S T.001 phase transition rise time
+#define RISE_TIME_MAX_US        150
+#define TRANSITION_DURATION_US  200
+#define TRANSITION_SAMPLES      US_TO_SAMPLES(TRANSITION_DURATION_US)   // 3 @32x, 5 @64x
+// First k with (k + 0.5) / N >= acos(1 - 2 x) / pi, fraction x 1e4
+#define TRANSITION_STEP(frac)   (((uint32_t)(frac) * TRANSITION_SAMPLES <= 5000UL) ? 0UL : \
+                                 ((uint32_t)(frac) * TRANSITION_SAMPLES - 5000UL + 9999UL) / 10000UL)
+#define TRANSITION_STEP_10      TRANSITION_STEP(2048)   // acos(0.8) / pi
+#define TRANSITION_STEP_90      TRANSITION_STEP(7952)   // acos(-0.8) / pi
+#define TRANSITION_RISE_US      ((TRANSITION_STEP_90 - TRANSITION_STEP_10) * 1000000UL / SAMPLE_RATE_HZ)  // 78 @32x, 117 @64x
+
+// =============================
+// Compile-time checks
+// =============================
+_Static_assert((OVERSAMPLING % 2) == 0, "OVERSAMPLING must be even (Biphase-L half bits)");
+_Static_assert(OVERSAMPLING >= 4 && OVERSAMPLING <= 128, "OVERSAMPLING out of range");
+_Static_assert((uint32_t)MESSAGE_BITS * 1000 == (uint32_t)MODULATED_DURATION_MS * SYMBOL_RATE_HZ,
+               "MODULATED_DURATION_MS does not match MESSAGE_BITS at SYMBOL_RATE_HZ");
+_Static_assert(((uint32_t)PREAMBLE_DURATION_MS * SAMPLE_RATE_HZ) % 1000 == 0,
+               "Preamble is not a whole number of samples");
+_Static_assert(((uint32_t)POSTAMBLE_DURATION_MS * SAMPLE_RATE_HZ) % 1000 == 0,
+               "Postamble is not a whole number of samples");
+_Static_assert(PREAMBLE_SAMPLES <= 0xFFFF && POSTAMBLE_SAMPLES <= 0xFFFF,
+               "Segment length overflows the 16-bit sample_count");
+_Static_assert(TIMER1_PR1 >= 1 && TIMER1_PR1 <= 0xFFFF, "Timer1 period does not fit PR1 (TCKPS 1:1)");
+_Static_assert(SAMPLE_RATE_ERR_PPM <= SAMPLE_RATE_TOL_PPM, "Sample rate error above tolerance");
+_Static_assert((FCY % TIMEBASE_HZ) == 0, "FCY is not a multiple of the timebase rate");
+_Static_assert(TIMEBASE_PERIOD <= 0xFFFF, "SCCP1 period does not fit CCP1PRL");
+_Static_assert(RAMP_SAMPLES_DEFAULT >= 1 && RAMP_SAMPLES_DEFAULT <= RAMP_SAMPLES_MAX,
+               "Default ramp outside the Q table");
+_Static_assert((uint32_t)RAMP_SAMPLES_DEFAULT * 1000000UL < 2000UL * SAMPLE_RATE_HZ,
+               "Default ramp longer than 2 ms");
+#if TRANSITION_SHAPING
+_Static_assert(TRANSITION_SAMPLES >= 1 && TRANSITION_SAMPLES <= SAMPLES_PER_HALF_BIT,
+               "Phase transition longer than a half bit");
+_Static_assert(TRANSITION_RISE_US >= RISE_TIME_MIN_US && TRANSITION_RISE_US <= RISE_TIME_MAX_US,
+               "Shaped transition misses the T.001 rise time window");
+#endif
+
+#endif // SYSTEM_CONFIG_H
@@ -4,22 +4,34 @@
 #include "system_comms.h"
 #include "system_debug.h"
 #include "protocol_data.h"
+#include "system_perf.h"
+#include "tx_impairments.h"
+#include "beacon_profiles.h"
+#include "rf_interface.h"
+#include "tx_telemetry.h"
 
 // =============================
 // Variables globales
 // =============================
 // Buffer debug
 volatile char debug_buf[DEBUG_BUF_SIZE];
-volatile uint16_t debug_head = 0;
-volatile uint16_t debug_tail = 0;
+spsc_ring_t debug_ring = { 0, 0, 0, DEBUG_BUF_SIZE - 1, (volatile uint8_t *)debug_buf };
 volatile char rxQueue[UART_BUFFER_SIZE];
 volatile uint16_t rxHead = 0;
 volatile uint16_t rxTail = 0;
 volatile uint8_t rxOverflowed = 0;
 volatile debug_flags_t debug_flags = {0};
-volatile char isr_log_buf[ISR_LOG_BUF_SIZE];
-volatile uint16_t isr_log_head = 0;
-volatile uint16_t isr_log_tail = 0;
+static volatile uint8_t isr_log_storage[ISR_LOG_BUF_SIZE];
+spsc_ring_t isr_log_ring = { 0, 0, 0, ISR_LOG_BUF_SIZE - 1, isr_log_storage };
+
+_Static_assert((ISR_LOG_BUF_SIZE & (ISR_LOG_BUF_SIZE - 1)) == 0,
+               "ISR_LOG_BUF_SIZE must be a power of two");
+_Static_assert((DEBUG_BUF_SIZE & (DEBUG_BUF_SIZE - 1)) == 0,
+               "DEBUG_BUF_SIZE must be a power of two");
+_Static_assert(DEBUG_BUF_SIZE + ISR_LOG_BUF_SIZE
+               + (WAVE_CAPTURE ? WAVE_CAPTURE_WORDS * sizeof(uint16_t) : 0) <= DEBUG_RAM_BUDGET,
+               "Debug buffers exceed DEBUG_RAM_BUDGET");
+_Static_assert(sizeof(isr_trace_rec_t) == 12, "isr_trace_rec_t must stay 12 bytes");
 // =============================
 
 
@@ -45,61 +57,125 @@ void uart_read_line(char* buffer, uint16_t max_len) {
     buffer[max_len - 1] = '\0';
 }
 
-// Version optimisee pour transfert logs ISR
-void isr_log_transfer_direct(void) {
-    while (isr_log_tail != isr_log_head) {
-        if (U2STAHbits.UTXBF) return;  // Bit 4 de U2STAH (1 = buffer TX plein)
+// Formatage des traces ISR (contexte main, quelques enregistrements par appel)
+void isr_trace_drain(void) {
+    isr_trace_rec_t rec;
+    
+    for (uint8_t n = 0; n < ISR_TRACE_DRAIN_MAX; n++) {
+        if (spsc_ring_count(&isr_log_ring) < sizeof(rec)) return;
+        // Laisser les traces dans leur ring tant que l'UART n'a pas la place
+        if (DEBUG_BUF_SIZE - spsc_ring_count(&debug_ring) < ISR_TRACE_LINE_MAX) return;
+        spsc_ring_pop(&isr_log_ring, &rec, sizeof(rec));
         
-        U2TXREG = isr_log_buf[isr_log_tail];
-        isr_log_tail = (isr_log_tail + 1) % ISR_LOG_BUF_SIZE;
+        debug_print_str("T:");
+        debug_print_uint32(rec.timestamp);
+        debug_print_str(" P:");
+        debug_print_uint16(rec.phase);
+        debug_print_str(" B:");
+        debug_print_uint16(rec.bit_index);
+        debug_print_str(" A:");
+        debug_print_uint16(rec.aux);
+        debug_print_str(" E:");
+        debug_print_uint16(rec.env);
+        debug_print_str(" D:");
+        debug_print_uint16(rec.dac);
+        debug_print_str("\r\n");
     }
 }
 
 
 // Fonctions de gestion du buffer debug
 // =============================
+// Producteurs : contexte main. Consommateur : _U2TXInterrupt.
+// Interruptions masquees (GIE = 0, ex. system_init) : emission en polling.
+static uint8_t debug_tx_polled(void) {
+    return !INTCON2bits.GIE;
+}
+
+// Vide le ring en attente active (mode polling uniquement)
+static void debug_tx_drain_polled(void) {
+    uint8_t c;
+    while (spsc_ring_pop(&debug_ring, &c, 1)) {
+        while (U2STAHbits.UTXBF);
+        U2TXREG = c;
+    }
+}
+
+static void debug_enqueue(const void *src, uint16_t len) {
+    if (debug_tx_polled()) {
+        const uint8_t *p = (const uint8_t *)src;
+        debug_tx_drain_polled();   // Conserver l'ordre
+        while (len--) {
+            while (U2STAHbits.UTXBF);
+            U2TXREG = *p++;
+        }
+        return;
+    }
+    spsc_ring_push(&debug_ring, src, len);  // Rejete et compte si plein
+    IEC1bits.U2TXIE = 1;                    // (Re)lancer l'emission
+}
+
 void debug_push_char(char c) {
-    // Version ultra-simplifiee
-    while(U2STAHbits.UTXBF);  // Attendre buffer libre
-    U2TXREG = c;
+    debug_enqueue(&c, 1);
 }
 
 void debug_push_str(const char *str) {
-    while (*str) {
-        debug_push_char(*str++);
+    debug_enqueue(str, strlen(str));
+}
+
+// Attend que le ring ait la place pour len octets (rapports longs)
+void debug_wait_room(uint16_t len) {
+    while (!debug_tx_polled() &&
+           DEBUG_BUF_SIZE - spsc_ring_count(&debug_ring) < len);
+}
+
+// Flux binaire : attend la place dans le ring au lieu de rejeter
+void debug_push_bin(const void *src, uint16_t len) {
+    const uint8_t *p = (const uint8_t *)src;
+    
+    while (len) {
+        uint16_t n = (len > WAVE_STREAM_CHUNK) ? WAVE_STREAM_CHUNK : len;
+        debug_wait_room(n);
+        debug_enqueue(p, n);
+        p += n;
+        len -= n;
     }
 }
 
+uint16_t debug_get_tx_dropped(void) {
+    return debug_ring.dropped;
+}
 
 void debug_flush(void) {
-    while (debug_tail != debug_head) {
-        if (!U2STAHbits.UTXBF) {
-            U2TXREG = debug_buf[debug_tail];
-            debug_tail = (debug_tail + 1) % DEBUG_BUF_SIZE;
-        } else {
-            break;
-        }
+    PERF_BEGIN(perf_t0);
+    
+    if (debug_tx_polled()) {
+        debug_tx_drain_polled();
+    } else if (spsc_ring_count(&debug_ring)) {
+        IEC1bits.U2TXIE = 1;
     }
+    PERF_END(PERF_UART_FLUSH, perf_t0);
 }
 
+// Ne bloque plus : l'emission continue sous interruption
 void debug_full_flush(void) {
-    uint32_t timeout = millis_counter + 500;  // Timeout apres 500ms
-    //uint32_t timeout = millis_counter + 100;  // Timeout apres 100ms
+    debug_flush();
+}
+
+// =============================
+// Interruption UART2 TX
+// =============================
+void __attribute__((__interrupt__, __auto_psv__)) _U2TXInterrupt(void) {
+    uint8_t c;
     
-    while (debug_tail != debug_head) {
-        uint32_t start_wait = millis_counter;
-        while (U2STAHbits.UTXBF && (millis_counter - start_wait < 10)); 
-        
-        if (U2STAHbits.UTXBF) break;  // Timeout
-        
-        U2TXREG = debug_buf[debug_tail];
-        debug_tail = (debug_tail + 1) % DEBUG_BUF_SIZE;
-        
-        if (millis_counter > timeout) break;  // Eviter les blocages infinis
+    while (!U2STAHbits.UTXBF) {
+        if (!spsc_ring_pop(&debug_ring, &c, 1)) {
+            IEC1bits.U2TXIE = 0;   // Plus rien a emettre
+            break;
+        }
+        U2TXREG = c;
     }
-    
-    uint32_t start_wait = millis_counter;
-    while (!U2STAbits.TRMT && (millis_counter - start_wait < 10));
+    IFS1bits.U2TXIF = 0;
 }
 
 void debug_print_uint16(uint16_t value) {
@@ -164,6 +240,12 @@ void init_debug_uart(void) {
     // 7. Test immediat
     while(U2STAHbits.UTXBF);  // Attendre buffer libre
     U2TXREG = 'T';  // Envoyer caractere test
+    
+    // 8. Emission sous interruption (activee a la demande par debug_enqueue)
+    U2STAHbits.UTXISEL = 0;  // Interruption des qu'une place est libre
+    IFS1bits.U2TXIF = 0;
+    IPC7bits.U2TXIP = 1;     // Priorite la plus basse
+    IEC1bits.U2TXIE = 0;
 }
 
 // =============================
@@ -320,39 +402,91 @@ void debug_print_int32(int32_t value) {
     debug_print_str(buffer);
 }
 
-void isr_log_push_char(char c) {
-    __builtin_disable_interrupts();
-    uint16_t next_head = (isr_log_head + 1) % ISR_LOG_BUF_SIZE;
-    if (next_head != isr_log_tail) {
-        isr_log_buf[isr_log_head] = c;
-        isr_log_head = next_head;
+// =============================
+// Ring SPSC
+// =============================
+// Reservation unique : l'enregistrement est copie en entier ou rejete
+uint8_t spsc_ring_push(spsc_ring_t *ring, const void *src, uint16_t len) {
+    const uint8_t *p = (const uint8_t *)src;
+    uint16_t head = ring->head;
+    uint16_t free_space = (uint16_t)(ring->mask + 1) - (uint16_t)(head - ring->tail);
+    
+    if (len > free_space) {
+        ring->dropped++;
+        return 0;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        ring->data[(uint16_t)(head + i) & ring->mask] = p[i];
     }
-    __builtin_enable_interrupts();
+    ring->head = head + len;  // Publication apres copie
+    return 1;
 }
 
-void isr_log_push_str(const char *str) {
-    while (*str) {
-        isr_log_push_char(*str++);
+uint16_t spsc_ring_pop(spsc_ring_t *ring, void *dst, uint16_t max_len) {
+    uint8_t *p = (uint8_t *)dst;
+    uint16_t tail = ring->tail;
+    uint16_t avail = (uint16_t)(ring->head - tail);
+    
+    if (avail > max_len) avail = max_len;
+    for (uint16_t i = 0; i < avail; i++) {
+        p[i] = ring->data[(uint16_t)(tail + i) & ring->mask];
     }
+    ring->tail = tail + avail;  // Liberation apres lecture
+    return avail;
 }
-void isr_log_push_hex_nibble(uint8_t value) {
-    value &= 0x0F;
-    isr_log_push_char(value < 10 ? '0' + value : 'A' + value - 10);
+
+uint16_t spsc_ring_count(const spsc_ring_t *ring) {
+    return (uint16_t)(ring->head - ring->tail);
 }
 
-void isr_log_push_uint16(uint16_t value) {
-    char buffer[6];
-    char *ptr = buffer + 5;
-    *ptr = '\0';
+// Producteur : Timer1 ISR uniquement
+uint8_t isr_log_push(const void *src, uint16_t len) {
+    return spsc_ring_push(&isr_log_ring, src, len);
+}
+
+// Un enregistrement par appel, aucun formatage en interruption
+void isr_trace_push(uint8_t aux, uint8_t env, uint16_t dac) {
+    isr_trace_rec_t rec;
     
-    do {
-        *--ptr = '0' + (value % 10);
-        value /= 10;
-    } while (value && ptr > buffer);
+    rec.timestamp = millis_counter;
+    rec.bit_index = bit_index;
+    rec.dac = dac;
+    rec.phase = (uint8_t)tx_phase;
+    rec.aux = aux;
+    rec.env = env;
+    rec.reserved = 0;
     
-    while (*ptr) {
-        isr_log_push_char(*ptr++);
-    }
+    isr_log_push(&rec, sizeof(rec));
+}
+
+// =============================
+// Export de la capture DAC (commande WAVE)
+// =============================
+// Trame little-endian : "WAVE" | version | OVERSAMPLING | SAMPLE_RATE_HZ (32)
+// | mots (16) | echantillons perdus (16) | mots RLE | somme des mots (16).
+// Emis d'un bloc pour qu'aucun log texte ne s'intercale (~90 ms pour 512 mots).
+void wave_capture_stream(void) {
+    uint16_t words, lost;
+    const uint16_t *buf = wave_capture_get(&words, &lost);
+    uint8_t hdr[WAVE_HEADER_SIZE];
+    uint32_t rate = SAMPLE_RATE_HZ;
+    uint16_t sum = 0;
+    
+    if (buf == NULL) return;
+    
+    memcpy(hdr, "WAVE", 4);
+    hdr[4] = WAVE_STREAM_VERSION;
+    hdr[5] = OVERSAMPLING;
+    memcpy(&hdr[6], &rate, 4);
+    memcpy(&hdr[10], &words, 2);
+    memcpy(&hdr[12], &lost, 2);
+    for (uint16_t i = 0; i < words; i++) sum += buf[i];
+    
+    debug_push_bin(hdr, sizeof(hdr));
+    debug_push_bin(buf, words * sizeof(uint16_t));
+    debug_push_bin(&sum, sizeof(sum));
+    DEBUG_LOG_FLUSH("\r\n");
+    wave_capture_release();
 }
 
 // =============================
@@ -386,6 +520,85 @@ void process_uart_commands(void) {
                 debug_flags.log_mode = LOG_MODE_NONE;
                 DEBUG_LOG_FLUSH("Debug mode: OFF\r\n");
             }
+            else if (strcmp(cmd_buffer, "WAVE") == 0) {
+                wave_capture_arm();
+                DEBUG_LOG_FLUSH(WAVE_CAPTURE ? "Wave capture armed (next burst)\r\n"
+                                             : "Wave capture disabled (WAVE_CAPTURE=0)\r\n");
+            }
+            else if (strcmp(cmd_buffer, "BCH TEST") == 0) {
+                // Balayage de plusieurs secondes : bloque rf_chain_task
+                if (tx_phase != IDLE_STATE) {
+                    DEBUG_LOG_FLUSH("BCH TEST: burst in progress, retry\r\n");
+                } else {
+                    bch_selftest();
+                }
+            }
+            else if (strncmp(cmd_buffer, "BCH ERR ", 8) == 0) {
+                // BCH ERR <bits BCH1> <bits BCH2> : corruption de chaque burst
+                char *end;
+                uint8_t n1 = (uint8_t)strtoul(&cmd_buffer[8], &end, 10);
+                uint8_t n2 = (uint8_t)strtoul(end, NULL, 10);
+                bch_set_error_injection(n1, n2);
+                DEBUG_LOG_FLUSH("BCH error injection: ");
+                debug_print_uint16(n1);
+                DEBUG_LOG_FLUSH(" / ");
+                debug_print_uint16(n2);
+                DEBUG_LOG_FLUSH(" bits\r\n");
+            }
+            else if (strncmp(cmd_buffer, "IMP", 3) == 0 &&
+                     (cmd_buffer[3] == '\0' || cmd_buffer[3] == ' ')) {
+                impair_command(&cmd_buffer[3]);
+            }
+            else if (strcmp(cmd_buffer, "SELFTEST") == 0) {
+                // Suite CS-T001 complete (bloquante) : hors burst uniquement
+                if (tx_phase != IDLE_STATE) {
+                    DEBUG_LOG_FLUSH("SELFTEST: burst in progress, retry\r\n");
+                } else {
+                    cs_t001_full_compliance_check();
+                    beacon_sched_invalidate();  // Back buffer reecrit par le test
+                }
+            }
+            else if (strncmp(cmd_buffer, "CHAN", 4) == 0 &&
+                     (cmd_buffer[4] == '\0' || cmd_buffer[4] == ' ')) {
+                // CHAN : liste des canaux ; CHAN <n> : reaccord hors burst
+                if (cmd_buffer[4] != '\0' && tx_phase != IDLE_STATE) {
+                    DEBUG_LOG_FLUSH("CHAN: burst in progress, retry\r\n");
+                } else {
+                    rf_channel_command(&cmd_buffer[4]);
+                }
+            }
+            else if (strncmp(cmd_buffer, "FORMAT", 6) == 0 &&
+                     (cmd_buffer[6] == '\0' || cmd_buffer[6] == ' ')) {
+                // FORMAT : format courant ; FORMAT T001 / T018 : balise principale
+                if (strcmp(&cmd_buffer[6], " T001") == 0) {
+                    beacon_sched_set_format(BEACON_FORMAT_FGB);
+                } else if (strcmp(&cmd_buffer[6], " T018") == 0) {
+                    if (!beacon_sched_set_format(BEACON_FORMAT_SGB)) {
+                        DEBUG_LOG_FLUSH("FORMAT: T.018 disabled (SGB_OQPSK=0)\r\n");
+                    }
+                } else if (cmd_buffer[6] != '\0') {
+                    DEBUG_LOG_FLUSH("FORMAT: T001 or T018\r\n");
+                }
+                DEBUG_LOG_FLUSH(beacon_sched_format() == BEACON_FORMAT_SGB ?
+                                "Format T.018\r\n" : "Format T.001\r\n");
+            }
+            else if (strcmp(cmd_buffer, "STATS") == 0) {
+                telemetry_report();
+            }
+            else if (strcmp(cmd_buffer, "STATS BIN") == 0) {
+                telemetry_stream();
+            }
+            else if (strcmp(cmd_buffer, "STATS RESET") == 0) {
+                telemetry_reset();
+                DEBUG_LOG_FLUSH("Burst statistics cleared\r\n");
+            }
+            else if (strcmp(cmd_buffer, "PERF") == 0) {
+                perf_report();
+            }
+            else if (strcmp(cmd_buffer, "PERF RESET") == 0) {
+                perf_reset();
+                DEBUG_LOG_FLUSH("Perf counters cleared\r\n");
+            }
             else {
                 DEBUG_LOG_FLUSH("Unknown command: ");
                 DEBUG_LOG_FLUSH(cmd_buffer);
@@ -404,16 +617,19 @@ void process_uart_commands(void) {
 void debug_system_status(void) {
     static uint32_t last_debug_time = 0;
     
-    if (millis_counter - last_debug_time >= 100) {
-        last_debug_time = millis_counter;
+    uint32_t now = timebase_millis();
+    if (now - last_debug_time >= 100) {
+        last_debug_time = now;
         
         char buf[64];
         snprintf(buf, sizeof(buf), 
-                "Mod:%u Phase:%X State:%u Gain:%.2f\r\n",
+                "Mod:%u Phase:%X State:%u Env:%u/%u Drop:%u\r\n",
                 modulation_counter,
                 carrier_phase & 0x0F,
                 tx_phase,
-                (double)envelope_gain);
+                envelope_step,
+                ramp_samples,
+                debug_ring.dropped);
         
         debug_push_str(buf);
     }
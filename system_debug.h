@@ -13,35 +13,58 @@
 #define UART1_BAUD_RATE    9600
 #define DEBUG_BAUD_RATE    115200
 // Tampons debogages
-#define DEBUG_BUF_SIZE     256
+#define DEBUG_BUF_SIZE     256    // Ring TX UART2 (puissance de 2), pertes comptees si plein
 #define UART_BUFFER_SIZE   128
-#define ISR_LOG_BUF_SIZE 2048  // Taille spcifique pour les logs ISR
+#define ISR_LOG_BUF_SIZE 2048  // Taille spcifique pour les logs ISR (puissance de 2)
+// Budget RAM des tampons debug (debug_buf + isr_log + capture WAVE) sur les
+// 8 Ko du dsPIC33CK64MC105 : le reste va aux trames, aux tampons OQPSK et a la pile
+#define DEBUG_RAM_BUDGET   3584
+#define ISR_TRACE_LINE_MAX 48  // Place reservee dans debug_ring par trace formatee
+#define ISR_TRACE_DRAIN_MAX 4  // Enregistrements formates par appel de isr_trace_drain()
+#define DEBUG_REPORT_LINE_MAX 128  // Place attendue par ligne des rapports STATS / PERF
+#define WAVE_STREAM_VERSION 1  // Format de la trame binaire WAVE
+#define WAVE_HEADER_SIZE   14
+#define WAVE_STREAM_CHUNK  64   // Octets pousses par attente de place dans debug_ring
 
 // =============================
 // Macros pour les logs
 // =============================
-// Macro pour logs avec flush automatique
+// Macro pour logs : mise en file, l'emission se fait sous interruption U2TX
 #define DEBUG_LOG_FLUSH(str) do { \
     debug_print_str(str); \
     debug_full_flush(); \
 } while(0)
 
-// Macro pour logs ISR
-#define ISR_LOG_PHASE(phase, env, dac) do { \
-    isr_log_push_char('P'); \
-    isr_log_push_char(':'); \
-    isr_log_push_hex_nibble(phase); \
-    isr_log_push_char(' '); \
-    isr_log_push_char('E'); \
-    isr_log_push_char(':'); \
-    isr_log_push_uint16((uint16_t)(env * 100)); \
-    isr_log_push_char(' '); \
-    isr_log_push_char('D'); \
-    isr_log_push_char(':'); \
-    isr_log_push_uint16(dac); \
-    isr_log_push_str("\r\n"); \
-} while(0)
+// Macro pour traces ISR : enregistrement binaire fixe, formatage dans main
+#define ISR_TRACE(aux, env, dac) \
+    isr_trace_push((uint8_t)(aux), (uint8_t)(env) /* envelope step */, (uint16_t)(dac))
 	
+// =============================
+// Ring buffer SPSC sans verrou
+// =============================
+// Un seul producteur (ecrit head) et un seul consommateur (ecrit tail).
+// Indices 16 bits libres, taille puissance de 2 : acces par masque,
+// occupation = head - tail. Aucun masquage d'interruptions.
+typedef struct {
+    volatile uint16_t head;       // Ecrit uniquement par le producteur
+    volatile uint16_t tail;       // Ecrit uniquement par le consommateur
+    volatile uint16_t dropped;    // Enregistrements rejetes (ring plein)
+    uint16_t mask;                // Taille - 1
+    volatile uint8_t *data;       // Stockage (taille puissance de 2)
+} spsc_ring_t;
+
+// Enregistrement de trace ISR (12 octets, little-endian)
+typedef struct {
+    uint32_t timestamp;   // millis_counter
+    uint16_t bit_index;   // Bit courant de la trame
+    uint16_t dac;         // Code DAC ecrit
+    uint8_t  phase;       // tx_phase_t
+    uint8_t  aux;         // Selon la phase : DATA = longueur du symbole (IMP JITTER),
+                          // IDLE = carrier_phase & 0x0F
+    uint8_t  env;         // Pas d'enveloppe
+    uint8_t  reserved;
+} isr_trace_rec_t;
+
 // =============================
 // Structure debug_flags_t
 // =============================
@@ -77,15 +100,21 @@ void debug_print_hex32(uint32_t value);
 void debug_print_hex64(uint64_t value);
 void debug_print_int(int value);
 void debug_push_str(const char *str); 
+void debug_push_bin(const void *src, uint16_t len);   // Blocking, binary streams
+void debug_wait_room(uint16_t len);                   // Blocking, multi-line reports
 void debug_flush(void);
 void debug_full_flush(void);
+uint16_t debug_get_tx_dropped(void);
 void debug_system_status(void);
 void debug_push_char(char c);
 uint8_t uart_get_line(char *buffer, uint16_t max_len);
-void isr_log_push_char(char c);
-void isr_log_push_str(const char *str);
-void isr_log_push_hex_nibble(uint8_t value);
-void isr_log_push_uint16(uint16_t value);
+uint8_t spsc_ring_push(spsc_ring_t *ring, const void *src, uint16_t len);
+uint16_t spsc_ring_pop(spsc_ring_t *ring, void *dst, uint16_t max_len);
+uint16_t spsc_ring_count(const spsc_ring_t *ring);
+uint8_t isr_log_push(const void *src, uint16_t len);
+void isr_trace_push(uint8_t aux, uint8_t env, uint16_t dac);
+void isr_trace_drain(void);
+void wave_capture_stream(void);
 uint8_t uart_data_available(void);
 void uart_read_line(char* buffer, uint16_t max_len);
 uint8_t uart_data_available(void);
@@ -100,12 +129,9 @@ extern volatile uint16_t rxHead;
 extern volatile uint16_t rxTail;
 extern volatile uint8_t rxOverflowed;
 extern volatile char debug_buf[DEBUG_BUF_SIZE];
-extern volatile uint16_t debug_head;
-extern volatile uint16_t debug_tail;
+extern spsc_ring_t debug_ring;
 extern volatile debug_flags_t debug_flags;
-extern volatile char isr_log_buf[ISR_LOG_BUF_SIZE];
-extern volatile uint16_t isr_log_head;
-extern volatile uint16_t isr_log_tail;
+extern spsc_ring_t isr_log_ring;
 
 
 #endif	/* SYSTEM_DEBUG_H */
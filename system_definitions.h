@@ -1,32 +1,16 @@
 #ifndef SYSTEM_DEFINITIONS_H
 #define SYSTEM_DEFINITIONS_H
 
+// Sample rate, oversampling and segment timing
+#include "system_config.h"
+
 // =============================
 // System Configuration Constants
 // =============================
 #define MIN_TX_INTERVAL_MS 5000      // Minimum 5 seconds between transmissions
-#define TOTAL_TX_DURATION_MS 840     // Total transmission duration (160+360+320)
 #define MAX_DUTY_CYCLE 0.06          // 10% maximum duty cycle
-#define PREAMBLE_BITS 16
-#define POSTAMBLE_BITS 8
-#define OVERSAMPLING 16
-#define TOTAL_SAMPLES_PER_BIT (OVERSAMPLING)
-#define MESSAGE_BITS 144
-
-// =============================
-// Configuration de la transmission
-// =============================
-// TOTAL_TX_DURATION_MS, MAX_DUTY_CYCLE, MIN_TX_INTERVAL_MS already defined there
-
-#define PREAMBLE_DURATION_MS 160
-#define MODULATED_DURATION_MS 360
-#define POSTAMBLE_DURATION_MS 320
-
-#define CARRIER_FREQ_HZ 40000
-#define SYMBOL_RATE_HZ 400
-#define SAMPLE_RATE_HZ 200000
-#define SAMPLES_PER_SYMBOL (SAMPLE_RATE_HZ / SYMBOL_RATE_HZ)
-#define SAMPLES_PER_HALF_BIT (SAMPLES_PER_SYMBOL / 2)
+#define MESSAGE_BYTES (MESSAGE_BITS / 8)    // 18 bytes packed
+#define FRAME_WORDS (MESSAGE_BITS / 16)     // 9 x 16-bit words packed
 
 // =============================
 // Power Control Definitions
@@ -47,9 +31,27 @@
 // =============================
 void system_init(void);
 void full_error_diagnostic(void);
-float read_pll_deviation(void);
 
-extern volatile uint8_t beacon_frame[MESSAGE_BITS];
+// =============================
+// Bit-packed 144-bit frame
+// =============================
+// CS-T001 bit 1 is the MSB of w[0], bit 144 the LSB of w[8]
+typedef struct {
+    uint16_t w[FRAME_WORDS];
+} packed_frame_t;
+
+// Read one bit by 0-based index (CS_BIT numbering) - shift only, ISR safe
+#define FRAME_BIT(f, idx)  (((f).w[(idx) >> 4] >> (15 - ((idx) & 0x0F))) & 1)
+// Read byte n (MSB-first transmission order)
+#define FRAME_BYTE(f, n)   ((uint8_t)((f).w[(n) >> 1] >> (((n) & 1) ? 0 : 8)))
+
+// Double-buffered frame: TX reads the active slot, the builder fills the other
+extern volatile packed_frame_t beacon_frames[2];
+extern volatile uint8_t tx_active_slot;   // Slot on air (latched by the ISR at ramp-up)
+extern volatile uint8_t tx_ready_slot;    // Slot published by the last start_transmission()
+
+// Back buffer: frame being built/validated, never the one the ISR is reading
+#define beacon_frame  (beacon_frames[tx_ready_slot ^ 1])
 
 // =============================
 // 
@@ -0,0 +1,126 @@
+/* system_perf.c - Cycle counters for ISR and frame-build profiling
+ * SCCP2 runs free at Tcy as a 32-bit timer (wraps every 85 s @50 MHz);
+ * sections read it at entry and exit and keep min/max/avg per counter.
+ * The PERF UART command prints the table, PERF RESET clears it. ISR
+ * times start after the context save, so they slightly under-read.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_debug.h"
+#include "system_perf.h"
+
+#if PERF_COUNTERS
+
+static perf_stat_t perf_stats[PERF_COUNT];
+
+static const char * const perf_names[PERF_COUNT] = {
+    "isr idle",
+    "isr ramp up",
+    "isr preamble",
+    "isr data",
+    "isr postamble",
+    "isr ramp down",
+    "frame build",
+    "frame encode",
+    "bch1",
+    "bch2",
+    "rf chain",
+    "uart flush",
+    "oqpsk render",
+};
+
+void perf_init(void) {
+    CCP2CON1L = 0;              // Timer mode (CCSEL=0, MOD=0000), Tcy clock, 1:1
+    CCP2CON1H = 0;
+    CCP2CON2L = 0;
+    CCP2CON2H = 0;
+    CCP2CON1Lbits.T32 = 1;      // CCP2TMRH:CCP2TMRL
+    CCP2TMRL = 0;
+    CCP2TMRH = 0;
+    CCP2PRL = 0xFFFF;           // Full 32-bit roll-over
+    CCP2PRH = 0xFFFF;
+    CCP2CON1Lbits.CCPON = 1;    // No interrupt: read only
+
+    perf_reset();
+    DEBUG_LOG_FLUSH("Perf: SCCP2 cycle counters\r\n");
+}
+
+// High word re-read: carry between the two halves
+uint32_t perf_cycles(void) {
+    uint16_t hi, lo;
+    do {
+        hi = CCP2TMRH;
+        lo = CCP2TMRL;
+    } while (hi != CCP2TMRH);
+    return ((uint32_t)hi << 16) | lo;
+}
+
+// Callable from any priority (rf_control_amplifier_chain runs in both
+// main and Timer1 contexts): a few cycles with interrupts masked.
+void perf_record(perf_id_t id, uint32_t cycles) {
+    perf_stat_t *s = &perf_stats[id];
+    uint8_t gie = INTCON2bits.GIE;
+
+    INTCON2bits.GIE = 0;
+    if (s->count == 0 || cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->total += cycles;
+    s->count++;
+    INTCON2bits.GIE = gie;
+}
+
+void perf_reset(void) {
+    uint8_t gie = INTCON2bits.GIE;
+
+    INTCON2bits.GIE = 0;
+    memset(perf_stats, 0, sizeof(perf_stats));
+    INTCON2bits.GIE = gie;
+}
+
+void perf_report(void) {
+    DEBUG_LOG_FLUSH("PERF section count min max avg (cycles)\r\n");
+
+    for (uint8_t i = 0; i < PERF_COUNT; i++) {
+        perf_stat_t s;
+        uint8_t gie = INTCON2bits.GIE;
+
+        INTCON2bits.GIE = 0;        // Consistent snapshot
+        s = perf_stats[i];
+        INTCON2bits.GIE = gie;
+
+        if (s.count == 0) continue;
+        debug_wait_room(DEBUG_REPORT_LINE_MAX);
+        DEBUG_LOG_FLUSH(perf_names[i]);
+        DEBUG_LOG_FLUSH(": ");
+        debug_print_uint32(s.count);
+        DEBUG_LOG_FLUSH(" ");
+        debug_print_uint32(s.min);
+        DEBUG_LOG_FLUSH(" ");
+        debug_print_uint32(s.max);
+        DEBUG_LOG_FLUSH(" ");
+        debug_print_uint32((uint32_t)(s.total / s.count));
+        if (i <= PERF_ISR_RAMP_DOWN) {
+            // Worst case as a share of the sample period
+            DEBUG_LOG_FLUSH(" load ");
+            debug_print_uint32(s.max * 100UL / TIMER1_PERIOD_TICKS);
+            DEBUG_LOG_FLUSH("%");
+        }
+        DEBUG_LOG_FLUSH("\r\n");
+    }
+    DEBUG_LOG_FLUSH("PERF period ");
+    debug_print_uint32(TIMER1_PERIOD_TICKS);
+    DEBUG_LOG_FLUSH(" cycles/sample\r\n");
+}
+
+#else
+
+void perf_init(void) {}
+uint32_t perf_cycles(void) { return 0; }
+void perf_record(perf_id_t id, uint32_t cycles) { (void)id; (void)cycles; }
+void perf_reset(void) {}
+
+void perf_report(void) {
+    DEBUG_LOG_FLUSH("PERF disabled (PERF_COUNTERS=0)\r\n");
+}
+
+#endif
@@ -0,0 +1,60 @@
+/* system_perf.h - Cycle counters for ISR and frame-build profiling */
+#ifndef SYSTEM_PERF_H
+#define SYSTEM_PERF_H
+
+#include <stdint.h>
+
+// =============================
+// Configuration
+// =============================
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS       1       // 0 = macros compile to nothing
+#endif
+
+// One counter per instrumented section. The ISR entries are indexed by
+// tx_phase at entry and must stay in tx_phase_t order.
+typedef enum {
+    PERF_ISR_IDLE = 0,
+    PERF_ISR_RAMP_UP,
+    PERF_ISR_PREAMBLE,
+    PERF_ISR_DATA,
+    PERF_ISR_POSTAMBLE,
+    PERF_ISR_RAMP_DOWN,
+    PERF_FRAME_BUILD,               // build_compliant_frame()
+    PERF_FRAME_ENCODE,              // frame_cache_update()
+    PERF_BCH1,                      // compute_bch1()
+    PERF_BCH2,                      // compute_bch2()
+    PERF_RF_CHAIN,                  // rf_control_amplifier_chain()
+    PERF_UART_FLUSH,                // debug_flush()
+    PERF_OQPSK_RENDER,              // T.018 chip render (prepare + DMA1 refill)
+    PERF_COUNT
+} perf_id_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;                   // Cycles (FCY)
+    uint32_t max;
+    uint64_t total;
+} perf_stat_t;
+
+// =============================
+// Macros
+// =============================
+#if PERF_COUNTERS
+#define PERF_BEGIN(t0)          uint32_t t0 = perf_cycles()
+#define PERF_END(id, t0)        perf_record((id), perf_cycles() - (t0))
+#else
+#define PERF_BEGIN(t0)          do { } while (0)
+#define PERF_END(id, t0)        do { } while (0)
+#endif
+
+// =============================
+// Prototypes
+// =============================
+void perf_init(void);                           // SCCP2 free-running 32-bit, Tcy
+uint32_t perf_cycles(void);
+void perf_record(perf_id_t id, uint32_t cycles);
+void perf_reset(void);
+void perf_report(void);                         // PERF command output
+
+#endif /* SYSTEM_PERF_H */
@@ -0,0 +1,84 @@
+/* system_scheduler.c - Cooperative deadline scheduler
+ * Tasks run to completion from main(); deadlines are absolute values of
+ * millis_counter so periodic tasks do not accumulate drift, and the core
+ * sits in Idle() until the next interrupt when nothing is due.
+ */
+#include "includes.h"
+#include "system_comms.h"
+#include "system_scheduler.h"
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static uint8_t sched_count = 0;
+
+// Wrap-safe "a is at or after b"
+#define SCHED_REACHED(a, b)  ((int32_t)((a) - (b)) >= 0)
+
+uint32_t sched_now(void) {
+    return timebase_millis();
+}
+
+void scheduler_init(void) {
+    memset(sched_tasks, 0, sizeof(sched_tasks));
+    sched_count = 0;
+}
+
+int8_t scheduler_add(sched_task_fn_t fn, uint32_t period_ms, uint32_t first_due) {
+    if (sched_count >= SCHED_MAX_TASKS || fn == NULL) return -1;
+    
+    sched_task_t *t = &sched_tasks[sched_count];
+    t->fn = fn;
+    t->period_ms = period_ms;
+    t->next_due = first_due;
+    t->armed = 1;
+    return (int8_t)sched_count++;
+}
+
+void sched_set_deadline(int8_t id, uint32_t due_ms) {
+    if (id < 0 || id >= sched_count) return;
+    sched_tasks[id].next_due = due_ms;
+    sched_tasks[id].armed = 1;
+}
+
+void sched_disarm(int8_t id) {
+    if (id < 0 || id >= sched_count) return;
+    sched_tasks[id].armed = 0;
+}
+
+// One scheduler pass: run every due task (earliest deadline first),
+// otherwise idle until the next interrupt (Timer1, UART ...)
+void scheduler_dispatch(void) {
+    uint8_t ran = 0;
+    
+    for (;;) {
+        uint32_t now = sched_now();
+        int8_t next = -1;
+        int32_t latest = -1;
+        
+        // Most overdue first; ties keep table order
+        for (uint8_t i = 0; i < sched_count; i++) {
+            sched_task_t *t = &sched_tasks[i];
+            int32_t late = (int32_t)(now - t->next_due);
+            if (t->armed && late >= 0 && late > latest) {
+                latest = late;
+                next = (int8_t)i;
+            }
+        }
+        if (next < 0) break;
+        
+        sched_task_t *t = &sched_tasks[next];
+        if (t->period_ms == SCHED_ONESHOT) {
+            t->armed = 0;                  // Task re-arms itself if needed
+        } else {
+            t->next_due += t->period_ms;   // Keep the phase, no drift
+            if (SCHED_REACHED(now, t->next_due)) {
+                t->next_due = now + t->period_ms;  // Overrun: skip missed slots
+            }
+        }
+        t->fn();
+        ran = 1;
+    }
+    
+    if (!ran) {
+        Idle();     // Woken by the next interrupt
+    }
+}
@@ -0,0 +1,32 @@
+/* system_scheduler.h - Cooperative deadline scheduler */
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include <stdint.h>
+
+// =============================
+// Configuration
+// =============================
+#define SCHED_MAX_TASKS     12      // Static task table size
+#define SCHED_ONESHOT       0       // period_ms: task sets its own next deadline
+
+typedef void (*sched_task_fn_t)(void);
+
+typedef struct {
+    sched_task_fn_t fn;             // Task body (runs to completion)
+    uint32_t period_ms;             // 0 = one-shot / self-rescheduled
+    uint32_t next_due;              // Absolute deadline (millis_counter)
+    uint8_t armed;                  // 0 = waiting for sched_set_deadline()
+} sched_task_t;
+
+// =============================
+// Prototypes
+// =============================
+void scheduler_init(void);
+int8_t scheduler_add(sched_task_fn_t fn, uint32_t period_ms, uint32_t first_due);
+void sched_set_deadline(int8_t id, uint32_t due_ms);   // Absolute deadline
+void sched_disarm(int8_t id);
+uint32_t sched_now(void);                              // SCCP1 timebase (ms)
+void scheduler_dispatch(void);                         // Run due tasks, else Idle()
+
+#endif /* SYSTEM_SCHEDULER_H */
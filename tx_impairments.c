@@ -0,0 +1,154 @@
+/* tx_impairments.c - Bit, phase and timing impairments for receiver tests
+ * Everything random is drawn once per burst in start_transmission(): the
+ * ISR only XORs one mask bit into each data bit and reads the symbol
+ * length from two more masks at each symbol boundary. The phase offset
+ * rebuilds the Q tables, the rate offset moves the Timer1 period, so
+ * neither costs anything in the ISR.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_comms.h"
+#include "system_debug.h"
+#include "protocol_data.h"
+#include "tx_impairments.h"
+
+#if TX_IMPAIRMENTS
+
+packed_frame_t impair_flip_mask;
+packed_frame_t impair_long_mask;
+packed_frame_t impair_short_mask;
+
+static struct {
+    uint8_t enabled;
+    uint8_t flip_bits[IMPAIR_FLIP_MAX];     // Frame bits 1-144 inverted every burst (0 = free)
+    uint32_t ber_ppm;                       // Random bit errors over the 144 bits
+    int16_t phase_offset_mrad;              // Added to the +/-1.1 rad deviation
+    uint16_t jitter_permille;               // Symbols one sample longer or shorter
+    int16_t rate_offset_ppm;                // Whole burst, via the Timer1 period
+} impair_cfg;
+
+static uint32_t impair_rand_state = 0x1F123BB5UL;
+static uint32_t impair_bursts = 0;          // Impaired bursts since IMP ON
+static uint16_t impair_last_flips = 0;      // Bits inverted in the last burst
+
+static uint32_t impair_rand(void) {
+    uint32_t x = impair_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    impair_rand_state = x;
+    return x;
+}
+
+static void mask_set(packed_frame_t *m, uint16_t idx) {
+    m->w[idx >> 4] |= (uint16_t)(0x8000u >> (idx & 0x0F));
+}
+
+void impair_prepare_burst(void) {
+    memset(&impair_flip_mask, 0, sizeof(impair_flip_mask));
+    memset(&impair_long_mask, 0, sizeof(impair_long_mask));
+    memset(&impair_short_mask, 0, sizeof(impair_short_mask));
+    impair_last_flips = 0;
+
+    if (!impair_cfg.enabled) {
+        set_phase_deviation(PHASE_SHIFT_RADIANS);
+        timer1_set_rate_offset(0);
+        return;
+    }
+
+    for (uint8_t i = 0; i < IMPAIR_FLIP_MAX; i++) {
+        if (impair_cfg.flip_bits[i]) mask_set(&impair_flip_mask, CS_BIT(impair_cfg.flip_bits[i]));
+    }
+    for (uint16_t idx = 0; idx < MESSAGE_BITS; idx++) {
+        if (impair_cfg.ber_ppm && impair_rand() % 1000000UL < impair_cfg.ber_ppm) {
+            impair_flip_mask.w[idx >> 4] ^= (uint16_t)(0x8000u >> (idx & 0x0F));
+        }
+        if (impair_cfg.jitter_permille && impair_rand() % 1000U < impair_cfg.jitter_permille) {
+            mask_set((impair_rand() & 1) ? &impair_long_mask : &impair_short_mask, idx);
+        }
+        impair_last_flips += FRAME_BIT(impair_flip_mask, idx);
+    }
+
+    set_phase_deviation(PHASE_SHIFT_RADIANS + (float)impair_cfg.phase_offset_mrad / 1000.0f);
+    timer1_set_rate_offset(impair_cfg.rate_offset_ppm);
+    impair_bursts++;
+}
+
+void impair_report(void) {
+    DEBUG_LOG_FLUSH(impair_cfg.enabled ? "IMP ON" : "IMP OFF");
+    DEBUG_LOG_FLUSH(" BER ");
+    debug_print_uint32(impair_cfg.ber_ppm);
+    DEBUG_LOG_FLUSH("ppm PHASE ");
+    debug_print_int32(impair_cfg.phase_offset_mrad);
+    DEBUG_LOG_FLUSH("mrad JITTER ");
+    debug_print_uint16(impair_cfg.jitter_permille);
+    DEBUG_LOG_FLUSH("/1000 RATE ");
+    debug_print_int32(impair_cfg.rate_offset_ppm);
+    DEBUG_LOG_FLUSH("ppm BITS");
+    for (uint8_t i = 0; i < IMPAIR_FLIP_MAX; i++) {
+        if (!impair_cfg.flip_bits[i]) continue;
+        DEBUG_LOG_FLUSH(" ");
+        debug_print_uint16(impair_cfg.flip_bits[i]);
+    }
+    DEBUG_LOG_FLUSH("\r\nBursts ");
+    debug_print_uint32(impair_bursts);
+    DEBUG_LOG_FLUSH(", last flips ");
+    debug_print_uint16(impair_last_flips);
+    DEBUG_LOG_FLUSH("\r\n");
+}
+
+static int32_t impair_clamp(int32_t v, int32_t lo, int32_t hi) {
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+// IMP | IMP ON/OFF | IMP BER <ppm> | IMP BIT <1-144, 0 = clear> |
+// IMP PHASE <mrad> | IMP JITTER <permille> | IMP RATE <ppm> | IMP SEED <n>
+// Setting a parameter enables the mode; it applies from the next burst.
+void impair_command(const char *args) {
+    while (*args == ' ') args++;
+    const char *arg = strchr(args, ' ');
+    int32_t v = arg ? strtol(arg + 1, NULL, 0) : 0;
+    uint8_t set = 1;
+
+    if (*args == '\0') {
+        set = 0;
+    } else if (strcmp(args, "ON") == 0) {
+        impair_bursts = 0;
+    } else if (strcmp(args, "OFF") == 0) {
+        impair_cfg.enabled = 0;
+        set = 0;
+    } else if (strncmp(args, "BER ", 4) == 0) {
+        impair_cfg.ber_ppm = (uint32_t)impair_clamp(v, 0, 1000000L);
+    } else if (strncmp(args, "BIT ", 4) == 0) {
+        if (v <= 0 || v > MESSAGE_BITS) {
+            memset(impair_cfg.flip_bits, 0, sizeof(impair_cfg.flip_bits));
+        } else {
+            uint8_t i = 0;
+            while (i < IMPAIR_FLIP_MAX && impair_cfg.flip_bits[i] && impair_cfg.flip_bits[i] != v) i++;
+            if (i < IMPAIR_FLIP_MAX) impair_cfg.flip_bits[i] = (uint8_t)v;
+        }
+    } else if (strncmp(args, "PHASE ", 6) == 0) {
+        impair_cfg.phase_offset_mrad = (int16_t)impair_clamp(v, -IMPAIR_PHASE_MAX_MRAD, IMPAIR_PHASE_MAX_MRAD);
+    } else if (strncmp(args, "JITTER ", 7) == 0) {
+        impair_cfg.jitter_permille = (uint16_t)impair_clamp(v, 0, IMPAIR_JITTER_MAX_PERMILLE);
+    } else if (strncmp(args, "RATE ", 5) == 0) {
+        impair_cfg.rate_offset_ppm = (int16_t)impair_clamp(v, -IMPAIR_RATE_MAX_PPM, IMPAIR_RATE_MAX_PPM);
+    } else if (strncmp(args, "SEED ", 5) == 0) {
+        impair_rand_state = v ? (uint32_t)v : 0x1F123BB5UL;     // Reproducible sequence
+        impair_bursts = 0;
+        set = 0;
+    } else {
+        DEBUG_LOG_FLUSH("IMP: ON OFF BER BIT PHASE JITTER RATE SEED\r\n");
+        return;
+    }
+    if (set) impair_cfg.enabled = 1;
+    impair_report();
+}
+
+#else
+
+void impair_prepare_burst(void) {}
+void impair_command(const char *args) { DEBUG_LOG_FLUSH("IMP disabled (TX_IMPAIRMENTS=0)\r\n"); }
+void impair_report(void) {}
+
+#endif
@@ -0,0 +1,40 @@
+/* tx_impairments.h - Bit, phase and timing impairments for receiver tests */
+#ifndef TX_IMPAIRMENTS_H
+#define TX_IMPAIRMENTS_H
+
+#include "system_definitions.h"
+
+// =============================
+// Configuration
+// =============================
+#ifndef TX_IMPAIRMENTS
+#define TX_IMPAIRMENTS              1   // 0 = ISR hooks compile out
+#endif
+#define IMPAIR_FLIP_MAX             8   // Fixed bit positions (IMP BIT)
+#define IMPAIR_PHASE_MAX_MRAD       500 // |offset| from PHASE_SHIFT_RADIANS
+#define IMPAIR_RATE_MAX_PPM         20000
+#define IMPAIR_JITTER_MAX_PERMILLE  1000
+
+// Per-burst masks, rebuilt by impair_prepare_burst() while the ISR is idle.
+// Bit n of a mask applies to frame bit n (CS_BIT numbering, as FRAME_BIT).
+#if TX_IMPAIRMENTS
+extern packed_frame_t impair_flip_mask;     // XORed with each data bit
+extern packed_frame_t impair_long_mask;     // Symbol lasts OVERSAMPLING + 1 samples
+extern packed_frame_t impair_short_mask;    // Symbol lasts OVERSAMPLING - 1 samples
+
+#define IMPAIR_BIT(idx)             FRAME_BIT(impair_flip_mask, idx)
+#define IMPAIR_SYMBOL_SAMPLES(idx)  (OVERSAMPLING + FRAME_BIT(impair_long_mask, idx) - \
+                                     FRAME_BIT(impair_short_mask, idx))
+#else
+#define IMPAIR_BIT(idx)             0
+#define IMPAIR_SYMBOL_SAMPLES(idx)  OVERSAMPLING
+#endif
+
+// =============================
+// Prototypes
+// =============================
+void impair_prepare_burst(void);            // start_transmission(), tx idle
+void impair_command(const char *args);      // "IMP ..." UART command
+void impair_report(void);
+
+#endif /* TX_IMPAIRMENTS_H */
@@ -0,0 +1,171 @@
+/* tx_oqpsk.c - T.018 OQPSK/DSSS burst playback: Q on the DAC, I on a PWM-DAC
+ * The Timer1 ISR does the ramp-up as for a T.001 burst, then hands over:
+ * Timer1 runs at the half-chip rate with its interrupt off and triggers
+ * three DMA channels per sample (Q code -> DAC1DATH, I duty -> PG1DC,
+ * next period -> PR1). The DMA1 half/done interrupt renders the next
+ * half of both ping-pong buffers; at the end Timer1 goes back to the
+ * sample rate for the ramp-down.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_comms.h"
+#include "system_debug.h"
+#include "system_perf.h"
+#include "sgb_frame.h"
+#include "tx_oqpsk.h"
+
+#if SGB_OQPSK
+
+volatile uint8_t oqpsk_pending = 0;
+
+static sgb_frame_t oqpsk_frame;                         // Copy on air, written while idle
+static sgb_modulator_t oqpsk_mod;
+static uint16_t oqpsk_q_buf[2 * OQPSK_HALF_SAMPLES];    // DAC codes
+static uint16_t oqpsk_i_buf[2 * OQPSK_HALF_SAMPLES];    // PWM duties
+static uint16_t oqpsk_period_buf[OQPSK_PERIOD_PATTERN]; // PR1 values (DMA reads RAM only)
+static volatile uint32_t oqpsk_played = 0;              // Samples played
+static uint16_t oqpsk_saved_pr1;                        // Sample-rate PR1 (IMP RATE included)
+
+void init_oqpsk_playback(void) {
+    const float bias = (float)ADL5375_BIAS_MV;
+    uint16_t q_plus = (uint16_t)(((bias + OQPSK_ARM_MV) * DAC_RESOLUTION) / 3300.0f);
+    uint16_t q_minus = (uint16_t)(((bias - OQPSK_ARM_MV) * DAC_RESOLUTION) / 3300.0f);
+
+    // Chip 0 -> +1, chip 1 -> -1, on both arms
+    oqpsk_mod.level_q[0] = q_plus;
+    oqpsk_mod.level_q[1] = q_minus;
+    oqpsk_mod.level_i[0] = PWM_I_DUTY(q_plus);
+    oqpsk_mod.level_i[1] = PWM_I_DUTY(q_minus);
+    oqpsk_mod.idle_q = ADL5375_BIAS_DAC_CODE;
+    oqpsk_mod.idle_i = PWM_I_DUTY(ADL5375_BIAS_DAC_CODE);
+
+    for (uint8_t i = 0; i < OQPSK_PERIOD_PATTERN; i++) {
+        oqpsk_period_buf[i] = (uint16_t)(OQPSK_PERIOD_TICKS - 1 + (i < OQPSK_PERIOD_LONG));
+    }
+
+    DMACONbits.DMAEN = 1;
+    DMACONbits.PRSSEL = 0;          // Fixed priority: Q, then I, then PR1
+    DMAL = 0x0000;
+    DMAH = 0xFFFF;
+
+    // Q: ping-pong into the DAC, half/done interrupt refills both channels
+    DMA1CH = 0;
+    DMA1CHbits.SIZE = 0;            // Word transfers
+    DMA1CHbits.TRMODE = 3;          // Repeated continuous
+    DMA1CHbits.SAMODE = 1;          // Source increments
+    DMA1CHbits.DAMODE = 0;          // Destination fixed
+    DMA1CHbits.RELOAD = 1;
+    DMA1INTbits.CHSEL = DMA_TRIGGER_TMR1;
+    DMA1INTbits.HALFEN = 1;
+    DMA1SRC = (uint16_t)oqpsk_q_buf;
+    DMA1DST = (uint16_t)&DAC1DATH;
+    DMA1CNT = 2 * OQPSK_HALF_SAMPLES;
+
+    // I: same layout into the PWM duty (UPDTRG: the write latches it)
+    DMA2CH = 0;
+    DMA2CHbits.SIZE = 0;
+    DMA2CHbits.TRMODE = 3;
+    DMA2CHbits.SAMODE = 1;
+    DMA2CHbits.DAMODE = 0;
+    DMA2CHbits.RELOAD = 1;
+    DMA2INTbits.CHSEL = DMA_TRIGGER_TMR1;
+    DMA2SRC = (uint16_t)oqpsk_i_buf;
+    DMA2DST = (uint16_t)&PG1DC;
+    DMA2CNT = 2 * OQPSK_HALF_SAMPLES;
+
+    // Period pattern, looped for the whole burst
+    DMA3CH = 0;
+    DMA3CHbits.SIZE = 0;
+    DMA3CHbits.TRMODE = 3;
+    DMA3CHbits.SAMODE = 1;
+    DMA3CHbits.DAMODE = 0;
+    DMA3CHbits.RELOAD = 1;
+    DMA3INTbits.CHSEL = DMA_TRIGGER_TMR1;
+    DMA3SRC = (uint16_t)oqpsk_period_buf;
+    DMA3DST = (uint16_t)&PR1;
+    DMA3CNT = OQPSK_PERIOD_PATTERN;
+
+    IPC3bits.DMA1IP = 5;            // As DMA0: below Timer1, above UART
+    IFS0bits.DMA1IF = 0;
+    IEC0bits.DMA1IE = 1;
+
+    DEBUG_LOG_FLUSH("OQPSK: DMA1-3 ready, ");
+    debug_print_uint32(OQPSK_SAMPLE_RATE_HZ);
+    DEBUG_LOG_FLUSH(" Hz half-chip clock\r\n");
+}
+
+// Pre-render both halves before the ramp-up (main context, DMA idle)
+void oqpsk_playback_prepare(const sgb_frame_t *frame) {
+    PERF_BEGIN(perf_t0);
+    oqpsk_frame = *frame;
+    sgb_mod_init(&oqpsk_mod, &oqpsk_frame);
+    sgb_mod_render(&oqpsk_mod, oqpsk_i_buf, oqpsk_q_buf, 2 * OQPSK_HALF_SAMPLES);
+    oqpsk_played = 0;
+
+    DMA1SRC = (uint16_t)oqpsk_q_buf;
+    DMA1CNT = 2 * OQPSK_HALF_SAMPLES;
+    DMA2SRC = (uint16_t)oqpsk_i_buf;
+    DMA2CNT = 2 * OQPSK_HALF_SAMPLES;
+    DMA3SRC = (uint16_t)oqpsk_period_buf;
+    DMA3CNT = OQPSK_PERIOD_PATTERN;
+    oqpsk_pending = 1;
+    PERF_END(PERF_OQPSK_RENDER, perf_t0);
+}
+
+// Timer1 switches to the half-chip clock; its ISR stays off until the end
+void oqpsk_playback_start(void) {
+    oqpsk_pending = 0;
+    dma_playback_active = 1;
+    IEC0bits.T1IE = 0;
+    oqpsk_saved_pr1 = PR1;
+    PR1 = oqpsk_period_buf[OQPSK_PERIOD_PATTERN - 1];
+    TMR1 = 0;
+    DMA1INTbits.HALFIF = 0;
+    DMA1INTbits.DONEIF = 0;
+    DMA1CHbits.CHEN = 1;
+    DMA2CHbits.CHEN = 1;
+    DMA3CHbits.CHEN = 1;            // First transfers on the next period match
+}
+
+void __attribute__((interrupt, auto_psv)) _DMA1Interrupt(void) {
+    PERF_BEGIN(perf_t0);
+    // DMA2 trails DMA1 by one transfer: the I sample it still has to read
+    // is the last one of the half, rewritten long after
+    uint16_t half = DMA1INTbits.HALFIF ? 0 : OQPSK_HALF_SAMPLES;
+    DMA1INTbits.HALFIF = 0;
+    DMA1INTbits.DONEIF = 0;
+
+    oqpsk_played += OQPSK_HALF_SAMPLES;
+
+    if (oqpsk_played >= OQPSK_BURST_SAMPLES) {
+        // Back to the sample clock for the ramp-down
+        DMA1CHbits.CHEN = 0;
+        DMA2CHbits.CHEN = 0;
+        DMA3CHbits.CHEN = 0;
+        PR1 = oqpsk_saved_pr1;
+        TMR1 = 0;
+        DAC1DATH = DAC_OFFSET;
+        PG1DC = oqpsk_mod.idle_i;
+        dma_playback_active = 0;
+        current_ramp_count = 0;
+        sample_count = 0;
+        tx_phase = POST_AMPLI_RAMP_DOWN;
+        IFS0bits.T1IF = 0;
+        IEC0bits.T1IE = 1;
+    } else {
+        // Position for status/logging: two transmitted bits per channel bit
+        uint16_t tx_bit = (uint16_t)(2 * (oqpsk_played / 2 / SGB_CHIPS_PER_BIT));
+        if (tx_bit < SGB_PREAMBLE_BITS) {
+            tx_phase = PREAMBLE_PHASE;
+        } else {
+            bit_index = tx_bit - SGB_PREAMBLE_BITS;
+            tx_phase = DATA_PHASE;
+        }
+        sgb_mod_render(&oqpsk_mod, &oqpsk_i_buf[half], &oqpsk_q_buf[half], OQPSK_HALF_SAMPLES);
+    }
+
+    IFS0bits.DMA1IF = 0;
+    PERF_END(PERF_OQPSK_RENDER, perf_t0);
+}
+
+#endif
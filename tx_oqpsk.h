@@ -0,0 +1,48 @@
+/* tx_oqpsk.h - T.018 OQPSK/DSSS burst playback: Q on the DAC, I on a PWM-DAC */
+#ifndef TX_OQPSK_H
+#define TX_OQPSK_H
+
+#include "system_definitions.h"
+#include "sgb_frame.h"
+
+// =============================
+// Configuration
+// =============================
+#ifndef SGB_OQPSK
+#define SGB_OQPSK               1       // 0 = second-generation bursts compile out
+#endif
+#define OQPSK_SAMPLE_RATE_HZ    (2 * SGB_CHIP_RATE_HZ)     // Half-chip clock, 76.8 kHz
+#define OQPSK_HALF_SAMPLES      64      // Per channel and half buffer (0.83 ms)
+#define OQPSK_BURST_SAMPLES     (2 * SGB_CHIPS_PER_CHANNEL + 1)   // Q ends half a chip late
+#define OQPSK_ARM_MV            177     // Per arm: same RF envelope as 250 mV on one arm
+
+// Timer1 period during the burst: FCY / 76800 = 651.04 is not an integer,
+// DMA3 replays a 24-period pattern into PR1 whose total is exact (15625).
+#define OQPSK_PERIOD_TICKS      (FCY / OQPSK_SAMPLE_RATE_HZ)   // 651
+#define OQPSK_PERIOD_PATTERN    24
+#define OQPSK_PERIOD_LONG       ((FCY % OQPSK_SAMPLE_RATE_HZ) * OQPSK_PERIOD_PATTERN / OQPSK_SAMPLE_RATE_HZ)
+
+// DMA channels (DMA0 stays with TX_DMA_PLAYBACK), all on the Timer1 trigger
+#define OQPSK_DMA_Q             1       // -> DAC1DATH
+#define OQPSK_DMA_I             2       // -> PG1DC
+#define OQPSK_DMA_PERIOD        3       // -> PR1
+
+_Static_assert(((FCY % OQPSK_SAMPLE_RATE_HZ) * OQPSK_PERIOD_PATTERN) % OQPSK_SAMPLE_RATE_HZ == 0,
+               "Period pattern does not give the exact half-chip rate");
+_Static_assert(OQPSK_HALF_SAMPLES % 32 == 0, "Half buffer must hold whole PRN words");
+_Static_assert(SGB_CHIPS_PER_BIT % 16 == 0, "Spreading factor must be a whole number of PRN words");
+
+// =============================
+// Prototypes
+// =============================
+#if SGB_OQPSK
+extern volatile uint8_t oqpsk_pending;          // Prepared, starts at the end of the ramp-up
+
+void start_transmission_sgb(const sgb_frame_t *frame);  // system_comms.c, tx idle only
+void init_oqpsk_playback(void);                 // DMA1-3 and the I-channel PWM
+void oqpsk_playback_prepare(const sgb_frame_t *frame);  // Main context, tx idle
+void oqpsk_playback_start(void);                // _T1Interrupt, end of PRE_AMPLI_RAMP_UP
+void __attribute__((__interrupt__, __auto_psv__)) _DMA1Interrupt(void);  // I/Q refill
+#endif
+
+#endif /* TX_OQPSK_H */
@@ -0,0 +1,211 @@
+/* tx_telemetry.c - Per-burst RF health and timing records
+ * start_burst_sequence() snapshots the running counters, the Timer1 ISR
+ * only stamps the start of the ramp-up and the end of the ramp-down, and
+ * a task closes the record into a fixed ring once the burst is over.
+ * Nothing is stored or formatted from interrupt context.
+ */
+#include "includes.h"
+#include "system_definitions.h"
+#include "system_comms.h"
+#include "system_debug.h"
+#include "protocol_data.h"
+#include "rf_interface.h"
+#include "sgb_frame.h"
+#include "tx_telemetry.h"
+
+static telemetry_record_t telem_ring[TELEMETRY_RING_SIZE];
+static uint16_t telem_count = 0;            // Records closed since reset (ring index)
+static uint16_t telem_seq = 0;              // Bursts since boot
+static telemetry_record_t telem_cur;        // Burst in progress
+static uint8_t telem_open = 0;
+static uint16_t telem_base_overruns;        // Counters at the start of the burst
+static uint16_t telem_base_drops;
+static uint16_t telem_base_losses;
+
+static struct {
+    uint16_t duration_min;
+    uint16_t duration_max;
+    uint16_t lock_max_us;
+    uint16_t lock_failures;
+    uint16_t over_budget;                   // Bursts longer than expected
+    uint32_t overruns;
+    uint32_t drops;
+    uint32_t losses;
+} telem_sum = { 0xFFFF, 0, 0, 0, 0, 0, 0, 0 };
+
+// Nominal on-air time: segments + both ramps (IMP RATE moves it on purpose)
+static uint16_t telemetry_budget_ms(uint8_t format) {
+    uint32_t ms = (format == BEACON_FORMAT_SGB) ? SGB_TX_DURATION_MS : TOTAL_TX_DURATION_MS;
+    return (uint16_t)(ms + (2UL * ramp_samples * 1000UL + SAMPLE_RATE_HZ - 1) / SAMPLE_RATE_HZ +
+                      TELEMETRY_BUDGET_TOL_MS);
+}
+
+static void telemetry_close(void) {
+    telemetry_record_t *r = &telem_cur;
+    uint32_t duration = tx_onair_end_ms - tx_onair_start_ms;
+    uint16_t losses = rf_adf4351_lock_losses() - telem_base_losses;
+    uint16_t lock_us;
+
+    r->start_ms = tx_onair_start_ms;
+    r->duration_ms = (duration > 0xFFFE) ? 0xFFFE : (uint16_t)duration;
+    r->isr_overruns = tx_isr_overruns - telem_base_overruns;
+    r->uart_drops = debug_get_tx_dropped() - telem_base_drops;
+    r->lock_losses = (losses > 0xFF) ? 0xFF : (uint8_t)losses;
+    // Retune (CHAN, RB13) or resume since the previous record
+    if (!rf_adf4351_relock_take(&lock_us)) r->lock_us = TELEMETRY_NONE;
+    else if (lock_us == ADF4351_LOCK_FAILED) r->lock_us = TELEMETRY_LOCK_FAILED;
+    else r->lock_us = lock_us;     // < 21 ms
+
+    telem_ring[telem_count & (TELEMETRY_RING_SIZE - 1)] = *r;
+    telem_count++;
+    telem_open = 0;
+
+    if (r->duration_ms < telem_sum.duration_min) telem_sum.duration_min = r->duration_ms;
+    if (r->duration_ms > telem_sum.duration_max) telem_sum.duration_max = r->duration_ms;
+    if (r->lock_us == TELEMETRY_LOCK_FAILED) telem_sum.lock_failures++;
+    else if (r->lock_us != TELEMETRY_NONE && r->lock_us > telem_sum.lock_max_us) {
+        telem_sum.lock_max_us = r->lock_us;
+    }
+    if (r->duration_ms > telemetry_budget_ms(r->format)) telem_sum.over_budget++;
+    telem_sum.overruns += r->isr_overruns;
+    telem_sum.drops += r->uart_drops;
+    telem_sum.losses += r->lock_losses;
+}
+
+// Tx idle: the ISR stamps are not written before the next ramp-up
+void telemetry_burst_begin(void) {
+    if (telem_open) telemetry_close();      // Task did not run since the last burst
+    uint32_t now = timebase_millis();
+
+    tx_onair_start_ms = now;                // Duration 0 if the burst never starts
+    tx_onair_end_ms = now;
+    telem_cur.seq = telem_seq++;
+    telem_cur.channel = rf_adf4351_get_channel();
+    telem_cur.profile = TELEMETRY_PROFILE_NONE;
+    telem_cur.format = BEACON_FORMAT_FGB;   // telemetry_tag_burst() has the profile's
+    telem_cur.gps_fix_age_s = gps_fix_age_s();
+    telem_base_overruns = tx_isr_overruns;
+    telem_base_drops = debug_get_tx_dropped();
+    telem_base_losses = rf_adf4351_lock_losses();
+    telem_open = 1;
+}
+
+void telemetry_tag_burst(uint8_t profile, uint8_t format, uint8_t uses_gps) {
+    if (!telem_open) return;
+    telem_cur.profile = profile;
+    telem_cur.format = format;
+    if (!uses_gps) telem_cur.gps_fix_age_s = TELEMETRY_NONE;
+}
+
+void telemetry_task(void) {
+    if (telem_open && tx_phase == IDLE_STATE) telemetry_close();
+}
+
+void telemetry_reset(void) {
+    telem_count = 0;
+    memset(&telem_sum, 0, sizeof(telem_sum));
+    telem_sum.duration_min = 0xFFFF;
+}
+
+static void telemetry_print_field(const char *name, uint16_t value) {
+    DEBUG_LOG_FLUSH(name);
+    if (value == TELEMETRY_NONE) DEBUG_LOG_FLUSH("-");
+    else debug_print_uint16(value);
+}
+
+static void telemetry_print_lock(const char *name, uint16_t value) {
+    if (value == TELEMETRY_LOCK_FAILED) {
+        DEBUG_LOG_FLUSH(name);
+        DEBUG_LOG_FLUSH("FAIL");
+    } else {
+        telemetry_print_field(name, value);
+    }
+}
+
+void telemetry_report(void) {
+    uint16_t n = (telem_count < TELEMETRY_RING_SIZE) ? telem_count : TELEMETRY_RING_SIZE;
+
+    debug_wait_room(DEBUG_REPORT_LINE_MAX);
+    DEBUG_LOG_FLUSH("STATS bursts ");
+    debug_print_uint16(telem_count);
+    DEBUG_LOG_FLUSH(", over budget ");
+    debug_print_uint16(telem_sum.over_budget);
+    DEBUG_LOG_FLUSH(", duration ");
+    debug_print_uint16(telem_count ? telem_sum.duration_min : 0);
+    DEBUG_LOG_FLUSH("-");
+    debug_print_uint16(telem_sum.duration_max);
+    DEBUG_LOG_FLUSH("ms, lock max ");
+    debug_print_uint16(telem_sum.lock_max_us);
+    DEBUG_LOG_FLUSH("us, lock fail ");
+    debug_print_uint16(telem_sum.lock_failures);
+    DEBUG_LOG_FLUSH("\r\nLock losses ");
+    debug_print_uint32(telem_sum.losses);
+    DEBUG_LOG_FLUSH(", ISR overruns ");
+    debug_print_uint32(telem_sum.overruns);
+    DEBUG_LOG_FLUSH(", UART drops ");
+    debug_print_uint32(telem_sum.drops);
+    DEBUG_LOG_FLUSH("\r\n");
+
+    // Oldest first
+    for (uint16_t i = telem_count - n; i != telem_count; i++) {
+        const telemetry_record_t *r = &telem_ring[i & (TELEMETRY_RING_SIZE - 1)];
+        debug_wait_room(DEBUG_REPORT_LINE_MAX);   // 16 lines do not fit the ring
+        DEBUG_LOG_FLUSH("#");
+        debug_print_uint16(r->seq);
+        DEBUG_LOG_FLUSH(" t=");
+        debug_print_uint32(r->start_ms);
+        telemetry_print_field(" dur=", r->duration_ms);
+        telemetry_print_lock(" lock=", r->lock_us);
+        telemetry_print_field(" loss=", r->lock_losses);
+        telemetry_print_field(" ovr=", r->isr_overruns);
+        telemetry_print_field(" drop=", r->uart_drops);
+        telemetry_print_field(" gps=", r->gps_fix_age_s);
+        telemetry_print_field(" ch=", r->channel);
+        if (r->profile != TELEMETRY_PROFILE_NONE) telemetry_print_field(" prof=", r->profile);
+        DEBUG_LOG_FLUSH(r->format == BEACON_FORMAT_SGB ? " T.018" : " T.001");
+        DEBUG_LOG_FLUSH(r->duration_ms > telemetry_budget_ms(r->format) ? " LATE\r\n" : "\r\n");
+    }
+}
+
+// Little-endian frame: "STAT" | version | record size | records (16)
+// | bursts since reset (16) | records, oldest first | byte sum (16)
+void telemetry_stream(void) {
+    uint16_t n = (telem_count < TELEMETRY_RING_SIZE) ? telem_count : TELEMETRY_RING_SIZE;
+    uint8_t hdr[TELEMETRY_HEADER_SIZE];
+    uint16_t sum = 0;
+
+    memcpy(hdr, "STAT", 4);
+    hdr[4] = TELEMETRY_STREAM_VERSION;
+    hdr[5] = sizeof(telemetry_record_t);
+    memcpy(&hdr[6], &n, 2);
+    memcpy(&hdr[8], &telem_count, 2);
+    debug_push_bin(hdr, sizeof(hdr));
+
+    for (uint16_t i = telem_count - n; i != telem_count; i++) {
+        const telemetry_record_t *r = &telem_ring[i & (TELEMETRY_RING_SIZE - 1)];
+        const uint8_t *p = (const uint8_t *)r;
+        for (uint8_t k = 0; k < sizeof(*r); k++) sum += p[k];
+        debug_push_bin(r, sizeof(*r));
+    }
+    debug_push_bin(&sum, sizeof(sum));
+    DEBUG_LOG_FLUSH("\r\n");
+}
+
+void telemetry_health_report(void) {
+    uint8_t ch = rf_adf4351_get_channel();
+    uint16_t lock_us = rf_adf4351_lock_time_us();
+
+    DEBUG_LOG_FLUSH("PLL: ");
+    DEBUG_LOG_FLUSH(rf_adf4351_locked() ? "LOCKED @ " : "UNLOCKED @ ");
+    debug_print_uint32(rf_adf4351_channel_khz(ch));
+    telemetry_print_lock(" kHz, last lock (us) ",
+                         lock_us == ADF4351_LOCK_FAILED ? TELEMETRY_LOCK_FAILED : lock_us);
+    DEBUG_LOG_FLUSH(", losses ");
+    debug_print_uint16(rf_adf4351_lock_losses());
+    DEBUG_LOG_FLUSH("\r\nTimer1 overruns ");
+    debug_print_uint16(tx_isr_overruns);
+    DEBUG_LOG_FLUSH(", UART drops ");
+    debug_print_uint16(debug_get_tx_dropped());
+    telemetry_print_field(", GPS fix age ", gps_fix_age_s());
+    DEBUG_LOG_FLUSH(" s\r\n");
+}
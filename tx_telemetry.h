@@ -0,0 +1,50 @@
+/* tx_telemetry.h - Per-burst RF health and timing records (STATS command) */
+#ifndef TX_TELEMETRY_H
+#define TX_TELEMETRY_H
+
+#include "system_definitions.h"
+
+// =============================
+// Configuration
+// =============================
+#define TELEMETRY_RING_SIZE      16      // Records kept, oldest overwritten (power of 2)
+#define TELEMETRY_TASK_MS        10      // Burst close-out polling
+#define TELEMETRY_BUDGET_TOL_MS  5       // Over nominal duration + ramps: counted as late
+#define TELEMETRY_STREAM_VERSION 1       // Format of the STATS BIN frame
+#define TELEMETRY_HEADER_SIZE    10
+#define TELEMETRY_NONE           0xFFFF  // Field not available
+#define TELEMETRY_LOCK_FAILED    0xFFFE  // lock_us: relock timed out
+#define TELEMETRY_PROFILE_NONE   0xFF    // Burst not started by the profile scheduler
+
+_Static_assert((TELEMETRY_RING_SIZE & (TELEMETRY_RING_SIZE - 1)) == 0,
+               "TELEMETRY_RING_SIZE must be a power of 2");
+
+// One burst, little-endian on the wire (STATS BIN)
+typedef struct {
+    uint32_t start_ms;          // Start of the ramp-up on air (timebase)
+    uint16_t seq;               // Burst number since boot
+    uint16_t duration_ms;       // Ramp-up start to end of ramp-down (Timer1 ISR stamps)
+    uint16_t lock_us;           // PLL relock before/in this burst, TELEMETRY_NONE = stayed locked
+    uint16_t isr_overruns;      // Timer1 periods lost during the burst
+    uint16_t uart_drops;        // Debug ring records dropped during the burst
+    uint16_t gps_fix_age_s;     // Age of the fix in the frame, TELEMETRY_NONE = none / fixed position
+    uint8_t lock_losses;        // LD falling edges while the RF chain was up
+    uint8_t channel;            // rf_channel_id_t
+    uint8_t profile;            // Beacon profile, TELEMETRY_PROFILE_NONE = single beacon
+    uint8_t format;             // BEACON_FORMAT_FGB / BEACON_FORMAT_SGB
+} telemetry_record_t;
+
+_Static_assert(sizeof(telemetry_record_t) == 20, "telemetry_record_t layout changed");
+
+// =============================
+// Prototypes
+// =============================
+void telemetry_burst_begin(void);       // start_burst_sequence(), tx idle
+void telemetry_tag_burst(uint8_t profile, uint8_t format, uint8_t uses_gps);  // After the start
+void telemetry_task(void);              // Task: close the burst once tx is idle
+void telemetry_report(void);            // STATS: summary + records, text
+void telemetry_stream(void);            // STATS BIN: binary export on UART2
+void telemetry_reset(void);             // STATS RESET
+void telemetry_health_report(void);     // PLL / timing health (diagnostic)
+
+#endif /* TX_TELEMETRY_H */